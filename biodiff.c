@@ -0,0 +1,5395 @@
+//Library      : libbiodiff
+//Explaination : The engine of Biodiff behind the API of biodiff.h: indices, inputs and outputs.
+//Author       : YuanEnming
+//Build        : gcc -O2 -c biodiff.c && ar rcs libbiodiff.a biodiff.o
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <zlib.h>
+#include <limits.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BIODIFF_X86        /* AVX2 and AVX-512 kernels, chosen when the processor has them */
+#include <immintrin.h>
+#endif
+#include "biodiff.h"
+
+#define FILE_BUFFER 1024
+#define LINE_BUFFER 512
+#define COLUMN_SIZE 256
+#define KEY_SIZE (LINE_BUFFER + 11 * BIODIFF_MAX_KEY)  /* an encoded key: the text of a line, 11 bytes more a column at most */
+#define BRANCH_SIZE 128
+#define RADIX_WIDTH 16     /* number of child keys compared at once */
+#define BLOOM_BLOCK 8      /* 64-bit words per Bloom block, one cache line */
+#define PROBE_BATCH 64     /* keys probed together at most */
+#define PROBE_DEFAULT 32   /* keys probed together by default */
+#define MIN_RUN 8          /* mean run length at which runs are merged instead of sorted */
+#define SAMPLE_ROWS 1000   /* rows read from each file to estimate the memory footprint */
+#define POINT_BATCH 64     /* positions searched together by c_point */
+#define POINT_NOT 1        /* c_point met a row that is not a single position */
+#define HUGE_PAGE 2097152  /* blocks of at least a huge page are mapped, in whole huge pages */
+#define PAGES(size) (((size) + HUGE_PAGE - 1) & ~((size_t) HUGE_PAGE - 1))
+#define MAX_PARTITIONS 256
+#define SHARD_SAMPLE 65536 /* left end points sampled for the cuts of the shards */
+#define ENGINE_TRIE BIODIFF_ENGINE_TRIE
+#define ENGINE_HASH BIODIFF_ENGINE_HASH
+#define ENGINE_PARTITION BIODIFF_ENGINE_PARTITION
+#define FORMAT_PLAIN 0
+#define FORMAT_GZIP 1
+#define FORMAT_BGZF 2      /* blocked gzip: independent blocks of at most BGZF_BLOCK bytes */
+#define BGZF_BLOCK 65536
+#define BGZF_BATCH 64      /* BGZF blocks decompressed in one parallel round */
+#define READ_CHUNK 262144
+#define BGZF_DATA 65280    /* bytes per BGZF output block, as bgzip writes them */
+#define COLUMNAR_MAGIC "BIODIFF\002"   /* the first 8 bytes of a columnar file */
+#define REGION_MAGIC "BIODIFFI"        /* the first 8 bytes of a binned index */
+#define SKETCH_MAGIC "BIODIFFK"        /* the first 8 bytes of a sketch */
+#define REGION_SUFFIX ".bdi"           /* the binned index of a file is the file name with it */
+#define REGION_SHIFT 14    /* 16 kb windows of the linear index, the span of the smallest bins */
+#define REGION_LIMIT ((1 << 29) - 1)   /* the largest coordinate the bins tell apart */
+#define REGION_BINS 37450  /* bins of the six levels: 1 + 8 + 64 + 512 + 4096 + 32768 */
+#define NOTEXIST 0
+#define EXIST 1
+#define SEPARATORS '\t'
+#define MARK(bits, i) ((bits)[(i) >> 3] |= 1 << ((i) & 7))   /* set bit i of a bitmap */
+#define MARKED(bits, i) ((bits)[(i) >> 3] >> ((i) & 7) & 1)
+#define MARK_BYTES(rows) ((rows) ? (((rows) - 1) >> 15 << 12) + 4096 : 0)   /* a bitset of a result as Mark_row grows it */
+#define MEMBER_WORDS(rows) ((rows) ? (((rows) - 1) >> 12 << 12) + 4096 : 0)   /* the words of a table as Mark_member grows them */
+#define PREFETCH(p) __builtin_prefetch(p)
+#define SPECIALIZE static inline __attribute__((always_inline))   /* constant arguments choose its code in every caller */
+#define PROBE_TRIE 0       /* the engines of Run_probes */
+#define PROBE_HASH 1
+#define PROBE_RADIX 2
+
+
+struct TrieNode /* the defination of structure TrieNode. */
+{
+    int exist;
+    struct TrieNode *next[BRANCH_SIZE];
+};
+
+typedef struct TrieNode TrieNode;
+
+struct Arena /* the nodes of a trie, carved out of chunks of a huge page and released at once. */
+{
+    char *chunk;               /* the newest chunk, every chunk starts with the one before */
+    size_t used;               /* bytes of the newest chunk handed out */
+    Biodiff_stats *stat;       /* charged with the chunks */
+    int failed;                /* a chunk could not be taken: keys are missing, the build fails */
+};
+
+struct RadixNode /* a node of the radix tree while it is being built. */
+{
+    int exist;
+    int len;                   /* length of the label run */
+    char *label;               /* the label run shared by all keys below */
+    int nchild;
+    int size;                  /* allocated child slots */
+    struct RadixNode **child;
+};
+
+typedef struct RadixNode RadixNode;
+
+struct RadixSlot /* a node of the frozen radix tree. */
+{
+    int label;                 /* offset of the label run in labels */
+    int len;                   /* length of the label run */
+    int first;                 /* index of the first child, children are contiguous */
+    int nchild;
+    int exist;                 /* a key ends here, for [-na] */
+};
+
+struct RadixTree /* the frozen radix tree, nodes in breadth-first order. */
+{
+    struct RadixSlot *slot;
+    unsigned char *key;        /* first byte of every node's label, parallel to slot */
+    char *labels;              /* all label runs in breadth-first order */
+    int nodes;
+    int length;                /* bytes of all label runs */
+};
+
+typedef struct RadixTree RadixTree;
+
+struct Bloom /* a blocked Bloom filter: every key sets its bits inside one cache line. */
+{
+    uint64_t *bits;
+    uint64_t blocks;           /* number of BLOOM_BLOCK-word blocks */
+    int k;                     /* bits set per key */
+};
+
+typedef struct Bloom Bloom;
+
+struct Hashes /* a growable list of key hashes, collected while an index is built. */
+{
+    uint64_t *hash;
+    long n;
+    long size;
+};
+
+struct HashIndex /* an open-addressing hash table of key strings. */
+{
+    uint64_t *hash;            /* key hash of every slot, 0 marks an empty slot */
+    long *key;                 /* offset of every slot's key in pool */
+    char *pool;                /* all keys, '\0' terminated */
+    long used, size;           /* bytes used and allocated in pool */
+    long n, slots;             /* keys stored and table size, a power of two */
+    uint64_t *member;          /* the tables holding every slot's key for Biodiff_compare_n, or NULL */
+    Biodiff_stats *stat;       /* charged with the table */
+};
+
+struct Index /* a key index of one file, built with the engine of the run plan. */
+{
+    int engine;                /* ENGINE_TRIE or ENGINE_HASH */
+    int mode;                  /* 1: total equal, 2: prefix */
+    TrieNode *trie;
+    RadixNode *build;          /* prefix keys are always kept in a radix tree */
+    RadixTree *radix;
+    struct HashIndex *table;
+    Bloom *bloom;              /* optional pre-filter for total equal */
+    struct Hashes hashes;      /* key hashes collected for the Bloom filter */
+    struct Arena arena;        /* the nodes of trie */
+    Biodiff_stats *stat;       /* charged with the index */
+};
+
+typedef struct Index Index;
+
+struct Probe /* one lookup of a batch, advanced a node at a time by Index_probe. */
+{
+    char *str;                 /* the part of the key still to match */
+    uint64_t h;                /* the hash of the key */
+    TrieNode *trie;            /* the node reached in a trie */
+    long slot;                 /* the slot reached in a hash table or a radix tree */
+    int stage;                 /* what the next step reads, -1 once the Bloom filter rejected the key or it has none */
+    int found, done;
+};
+
+struct Batch /* rows read ahead of their probes, so that the probes of a batch run together. */
+{
+    int n;
+    char *key[PROBE_BATCH];
+    int found[PROBE_BATCH];
+    char line[PROBE_BATCH][LINE_BUFFER];
+    char column[PROBE_BATCH][KEY_SIZE];
+};
+
+struct Approx /* a search of a radix tree for the keys within some edits of a key, see Search_approx. */
+{
+    RadixTree *tree;
+    const char *key;
+    int len, k;                /* the length of the key and the edits allowed */
+    int *rows;                 /* the edit distances to the key, a row of len + 1 for every depth */
+    long size;                 /* entries allocated in rows */
+    long nodes;                /* nodes visited */
+    Biodiff_stats *stat;       /* charged with rows */
+};
+
+struct Sample /* what the first rows of a file tell about the whole file. */
+{
+    double rows;               /* estimated number of rows */
+    double key;                /* mean key length */
+    double nodes;              /* trie nodes created per key */
+};
+
+struct Pool /* worker threads running the iterations of one parallel loop at a time. */
+{
+    pthread_t *thread;
+    int threads;
+    pthread_mutex_t lock;
+    pthread_cond_t start, done;
+    void (*job)(void *arg, int i);
+    void *arg;
+    int next, count, finished;
+    int round;                 /* counts the loops, so a worker starts each loop once */
+    int quit;
+};
+
+typedef struct Pool Pool;
+
+struct Reader /* an input file: plain text, gzip or BGZF, read from a file or a pipe. */
+{
+    int fd;
+    int format;                /* FORMAT_PLAIN, FORMAT_GZIP or FORMAT_BGZF */
+    int seekable;              /* a regular file is read again from its start, a pipe is spooled */
+    int eof;                   /* fd is exhausted */
+    double size;               /* size of a regular file, 0 for a pipe */
+    unsigned char *raw;        /* bytes read from fd and not yet decoded */
+    size_t raw_len, raw_pos, raw_size;
+    unsigned char *buf;        /* decoded bytes */
+    size_t buf_size;
+    unsigned char *data;       /* the decoded bytes being read: buf, or a part of spool */
+    size_t len, pos;
+    z_stream zs;               /* the gzip decoder */
+    unsigned char *spool;      /* every decoded byte of a pipe, read again after a rewind */
+    size_t spool_len, spool_pos, spool_size;
+    double in, out;            /* bytes consumed and bytes decoded */
+    int error;                 /* the file can not be decompressed, it reads as ended */
+    Biodiff *bd;               /* the context whose threads decompress BGZF blocks */
+};
+
+typedef struct Reader Reader;
+
+struct Biodiff_writer /* an output file: plain text, or BGZF compressed in parallel. */
+{
+    FILE *file;
+    int bgzf;
+    unsigned char *buf;        /* bytes of the blocks not yet compressed */
+    size_t len;
+    unsigned char *out;        /* the compressed blocks of one batch */
+    uint64_t coffset;          /* bytes written to file */
+    uint64_t uoffset;          /* bytes compressed */
+    char *gzi;                 /* name of the .gzi index, NULL for none */
+    uint64_t *index;           /* compressed and uncompressed offset of every block but the first */
+    long entries, size;
+    Biodiff *bd;               /* the context whose threads compress the blocks */
+};
+
+typedef struct Biodiff_writer Writer;
+
+struct Biodiff /* a context: the options, the worker threads, the counters and the last error. */
+{
+    Biodiff_options opt;
+    Biodiff_stats stat;
+    Pool *workers;             /* NULL when the context has one thread */
+    char error[LINE_BUFFER];
+    void (*log)(void *arg, const char *line);
+    void *log_arg;
+    long (*run_end)(const int *start, long from, long to, int x);   /* Run_end or a kernel of it */
+    int perf_fd[BIODIFF_EVENTS];   /* the counters of opt.perf, one group led by the first */
+    int perf_event[BIODIFF_EVENTS];   /* the event of every counter */
+    int perf_n;                /* counters open */
+    long long perf_last[BIODIFF_EVENTS];   /* the events counted at the last change of phase */
+    int phase;                 /* the BIODIFF_PHASE_* the events are charged to, -1 between calls */
+};
+
+struct Venn_interval /* an interval of one of the tables of c_venn. */
+{
+    const struct Interval *interval;
+    int table;
+};
+
+struct Interval /* the coordinates of a row for [-co]. */
+{
+    char *start, *end;         /* end is stored right after start, or both are in a columnar file */
+    int left, right;           /* the ends as numbers, converted once */
+    long row;                  /* the row, from 1 */
+};
+
+struct Span /* intervals merged where they overlap, for options.cover. */
+{
+    int64_t left, right;
+};
+
+struct Columnar_header /* the start of a columnar file, every offset is from the start of the file. */
+{
+    char magic[8];             /* COLUMNAR_MAGIC */
+    int64_t rows, cols;        /* records, and columns of the widest record */
+    int64_t text, text_size;   /* the decoded source, its records cut as Biodiff_table_buffer cuts them */
+    int64_t line;              /* the start of every record in the text */
+    int64_t column;            /* a Column_header for every column */
+    int64_t source;            /* the path of the plain file the text is, ended by 0; 0 when the text is here */
+    int64_t source_mtime;      /* of that file in ns, to tell when it has changed */
+};
+
+struct Column_header /* one column of a columnar file. */
+{
+    int64_t words;             /* distinct values */
+    int64_t dict;              /* words + 1 offsets into strings */
+    int64_t strings;           /* the distinct values in strcmp order, each ended by 0 */
+    int64_t id;                /* the uint32_t rank of every row's value in the dictionary */
+    int64_t order;             /* uint32_t rows sorted by number, 0 unless every value is an integer */
+    int64_t delta;             /* the sorted numbers as zigzag varints of their differences */
+};
+
+struct Columns /* a columnar file mapped into memory. */
+{
+    unsigned char *map;
+    size_t size;
+    const struct Columnar_header *head;
+    const struct Column_header *column;
+    const char *text;          /* the records, in the file or in the mapped source */
+    unsigned char *source;     /* the mapping of the source, NULL when the text is in the file */
+    int64_t **number;          /* the numbers of every column, decoded when [-co] first needs them */
+    Biodiff_stats *stat;       /* the counters they are charged to */
+};
+
+struct Region_header /* the start of a binned index, every offset is from the start of the file. */
+{
+    char magic[8];             /* REGION_MAGIC */
+    int32_t col[4];            /* the sequence column, 0 for none, the two coordinate columns and 0 */
+    int64_t size, mtime;       /* of the indexed file, mtime in ns, to tell when the index is stale */
+    int64_t sequences;         /* distinct sequence names */
+    int64_t sequence;          /* a Region_sequence for each */
+};
+
+struct Region_sequence /* the bins and the linear index of one sequence. */
+{
+    int64_t name;              /* its name, ended by 0 */
+    int64_t chunks, chunk;     /* Region_chunk sorted by bin then by offset */
+    int64_t windows, window;   /* the first record overlapping each window or a later one */
+};
+
+struct Region_chunk /* records next to each other in the file and in the same bin. */
+{
+    int64_t bin;
+    int64_t begin, end;        /* their bytes in the decoded file, end excluded */
+};
+
+struct Binning /* a sequence while its binned index is built. */
+{
+    char *name;
+    struct Region_chunk *chunk;
+    long chunks, size;
+    int64_t *window;
+    long windows;
+};
+
+struct Regions /* a binned index mapped into memory. */
+{
+    unsigned char *map;
+    size_t size;
+    const struct Region_header *head;
+    const struct Region_sequence *sequence;
+};
+
+struct Biodiff_table /* the records of one input, their key columns and the indices built on them. */
+{
+    int col[BIODIFF_MAX_KEY + 1];   /* key columns, from 1, ended by 0 */
+    int type[BIODIFF_MAX_KEY]; /* BIODIFF_KEY_INT or BIODIFF_KEY_FOLD of each, 0 for a string */
+    int keys;                  /* how many; a key of more or of a typed one is encoded, see Encode_key */
+    Reader *reader;            /* a file, owned by the table */
+    Biodiff_source source;     /* an iterator */
+    const char *data;          /* a buffer, or the text of a columnar file */
+    size_t size;
+    int64_t *offset;           /* start of every record in data */
+    char *held;                /* the records of a region table, owned by the table */
+    struct Columns *columns;   /* a columnar file, owned by the table */
+    long rows;                 /* -1 until the table has been read through */
+    int passes;                /* passes started over the records */
+    Index *index[3];           /* indices of BIODIFF_EQUAL [1] and BIODIFF_PREFIX [2] */
+    struct Interval *interval; /* intervals of BIODIFF_OVERLAP, sorted, from 1 */
+    long intervals;            /* of them: the rows, or those of the shard of the context */
+    int *left, *right;         /* their end points as numbers, apart for Sweep */
+    Biodiff_stats *stat;       /* the stats of the context that created the table, charged with its memory */
+};
+
+struct Cursor /* one pass over the records of a table. */
+{
+    Biodiff_table *table;
+    long row;                  /* the next record of a buffer */
+    long count;                /* records passed so far */
+    int64_t at, next;          /* where the record starts in the decoded bytes, and the next one */
+    int fold;                  /* BIODIFF_FOLD_* flags of the keys */
+    int shard;                 /* the mode by which Next_batch keeps the keys of the shard, 0 for all */
+    int long_key;              /* a key was cut at KEY_SIZE, see Encode_key */
+    char line[LINE_BUFFER];
+};
+
+
+/* k_diff: key-based differences with an in-memory index, for [-ce], [-ne] and [-no] */
+static int k_diff(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, Biodiff_result *result, int mode);
+/* p_diff: key-based differences with the keys split into partitions on disk */
+static int p_diff(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, Biodiff_result *result, int mode);
+/* a_diff: name-based differences within some edits, for [-na] */
+static int a_diff(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, Biodiff_result *result);
+/* c_overlap: coordinated-based overlap differences */
+static int c_overlap(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, Biodiff_result *result);
+/* c_point: [-co] of a side of single positions against the intervals of the other, without sorting the positions */
+static int c_point(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, int side, Biodiff_result *result);
+/* Point_table: whether the first rows of a table are single positions and its intervals are not kept */
+static int Point_table(Biodiff *bd, Biodiff_table *table);
+/* Digit_order: gather what tells whether positions sort as strings the way they sort as numbers */
+static int Digit_order(const char *s, int64_t *most, int64_t *least);
+/* Eytzinger: lay out sorted bounds in Eytzinger order, the children of node k at 2k and 2k + 1 */
+static long Eytzinger(const int64_t *sorted, long m, int64_t *key, int *rank, long size, long i, long k);
+/* Pass_marks: pass the rows of both tables to the result by their marks, from 1, and release the marks */
+static int Pass_marks(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, unsigned char *mark_A, unsigned char *mark_B, Biodiff_result *result);
+/* Merge_spans: merge the overlapping intervals of a table in their sorted order into spans */
+static long Merge_spans(Biodiff *bd, const int *left, const int *right, long n, struct Span *span);
+/* Cover_spans: count the base pairs of [-co] covered by each table and by both */
+static void Cover_spans(Biodiff *bd, Biodiff_table *A, Biodiff_table *B);
+/* Cmp_span: the comparison function for qsort of spans, by their left end */
+static int Cmp_span(const void *a, const void *b);
+/* c_venn: coordinate-based overlaps among n tables in one sweep */
+static int c_venn(Biodiff *bd, Biodiff_table **table, int n, Biodiff_venn *venn);
+/* Venn_sweep: the two sweeps of c_venn, for one kind of coordinates */
+SPECIALIZE void Venn_sweep(struct Venn_interval *all, long total, int n, uint64_t **member, int coord);
+/* Mark_member: record which tables hold a match of a row and pass it to the callback */
+static void Mark_member(Biodiff_venn *venn, int table, long row, uint64_t member, char *line);
+/* Cmp_venn_number: the comparison function for qsort of the intervals of c_venn, by their left end points as numbers */
+static int Cmp_venn_number(const void *a, const void *b);
+/* Cmp_venn_string: the comparison function for qsort of the intervals of c_venn, by their left end points as strings */
+static int Cmp_venn_string(const void *a, const void *b);
+/* create a tire tree root */
+static TrieNode *Create_tire(Biodiff *bd, struct Arena *arena);
+/* insert a node to the trie tree */
+static void Insert_trie(Biodiff *bd, struct Arena *arena, TrieNode *root, char *word);
+/* search for a string according to a trie tree based on total equal*/
+static int Search_trie1(TrieNode *root, char *word);
+/* create a radix tree root */
+static RadixNode *Create_radix(Biodiff_stats *stat);
+/* insert a string to the radix tree */
+static void Insert_radix(Biodiff_stats *stat, RadixNode *root, char *word);
+/* freeze a radix tree into a contiguous breadth-first layout and release it */
+static RadixTree *Freeze_radix(Biodiff *bd, Biodiff_stats *stat, RadixNode *root);
+/* search for a string according to a radix tree based on prefix equal */
+static int Search_radix(RadixTree *tree, char *word);
+/* search for the keys of a radix tree within some edits of a string */
+static int Search_approx(struct Approx *approx, char *word);
+/* walk the children of a radix node with the edit distances of their labels */
+static int Walk_approx(struct Approx *approx, int slot, int depth);
+/* follow the rest of a string exactly from inside the label of a radix node */
+static int Exact_approx(struct Approx *approx, int slot, int at, int j);
+/* release a frozen radix tree */
+static void Free_radix(Biodiff_stats *stat, RadixTree *tree);
+/* release a radix tree that was not frozen */
+static void Drop_radix(Biodiff_stats *stat, RadixNode *node);
+/* Hash_key: hash a key string for the Bloom filter */
+static uint64_t Hash_key(char *word);
+/* Push_hash: append a key hash to a list */
+static void Push_hash(Biodiff_stats *stat, struct Hashes *list, uint64_t h);
+/* Create_bloom: create a Bloom filter for a list of key hashes at the target false-positive rate */
+static Bloom *Create_bloom(Biodiff *bd, Biodiff_stats *stat, struct Hashes *list, double fpr);
+/* Search_bloom: whether a key hash may be in the filter */
+static int Search_bloom(Bloom *filter, uint64_t h);
+/* Free_bloom: release a Bloom filter */
+static void Free_bloom(Biodiff_stats *stat, Bloom *filter);
+/* Create_hash: create an empty hash table of key strings */
+static struct HashIndex *Create_hash(Biodiff *bd, Biodiff_stats *stat, long n);
+/* Insert_hash: insert a key string with its hash to the hash table */
+static void Insert_hash(Biodiff *bd, struct HashIndex *table, char *word, uint64_t h);
+/* Search_hash: search for a key string in the hash table based on total equal */
+static int Search_hash(struct HashIndex *table, char *word, uint64_t h);
+/* Member_hash: the word of the tables holding a key, the key inserted when it is new */
+static uint64_t *Member_hash(Biodiff *bd, struct HashIndex *table, char *word, uint64_t h);
+/* Free_hash: release a hash table */
+static void Free_hash(struct HashIndex *table);
+/* Index_create: create an empty key index with an engine */
+static Index *Index_create(Biodiff *bd, Biodiff_stats *stat, int engine, int mode);
+/* Index_insert: insert a key to the index */
+static void Index_insert(Biodiff *bd, Index *index, char *word);
+/* Index_ready: finish building the index before it is searched */
+static int Index_ready(Biodiff *bd, Index *index);
+/* Index_search: search for a key in the index, consulting its Bloom filter first */
+static int Index_search(Biodiff *bd, Index *index, char *word);
+/* Index_probe: search for a batch of keys at once, their lookups interleaved */
+static void Index_probe(Biodiff *bd, Index *index, char **word, int n, int *found);
+/* Run_probes: advance the lookups of a batch until all are done, for one engine */
+SPECIALIZE void Run_probes(Index *index, struct Probe *probe, int n, int live, int engine);
+/* Index_free: release the index */
+static void Index_free(Index *index);
+/* Free_arena: release the nodes of a whole trie tree */
+static void Free_arena(struct Arena *arena);
+/* Shape_trie: count the nodes of a trie by depth and by children */
+static void Shape_trie(Biodiff_stats *stat, TrieNode *node, int depth);
+/* Shape_radix: count the nodes of a radix tree by depth and by children */
+static void Shape_radix(Biodiff_stats *stat, RadixTree *tree);
+/* Sample_file: estimate the rows and the key shape of a table from its first rows */
+static int Sample_file(Biodiff *bd, Biodiff_table *table, int trie, struct Sample *sample);
+/* Perf_open: open the hardware counters of opt.perf on the calling thread */
+static void Perf_open(Biodiff *bd);
+/* Perf_phase: charge the events since the last change to the phase left and enter another, returning the one left */
+static int Perf_phase(Biodiff *bd, int phase);
+/* Account: charge bytes and blocks to a kind of memory, negative to release them */
+static void Account(Biodiff_stats *stat, int tag, long long bytes, long blocks);
+/* Take: malloc charged to a kind of memory */
+static void *Take(Biodiff_stats *stat, int tag, size_t size);
+/* Take_zero: calloc charged to a kind of memory */
+static void *Take_zero(Biodiff_stats *stat, int tag, size_t n, size_t size);
+/* Retake: realloc charged to a kind of memory, the old size given */
+static void *Retake(Biodiff_stats *stat, int tag, void *p, size_t old, size_t size);
+/* Give: free charged to a kind of memory, the size given */
+static void Give(Biodiff_stats *stat, int tag, void *p, size_t size);
+/* Map_pages: map whole huge pages, placed as the context says */
+static void *Map_pages(Biodiff *bd, size_t size);
+/* Take_pages: Take for a large block, mapped from huge pages from HUGE_PAGE bytes on */
+static void *Take_pages(Biodiff *bd, Biodiff_stats *stat, int tag, size_t size);
+/* Take_pages_zero: Take_zero for a large block */
+static void *Take_pages_zero(Biodiff *bd, Biodiff_stats *stat, int tag, size_t n, size_t size);
+/* Retake_pages: Retake for a large block */
+static void *Retake_pages(Biodiff *bd, Biodiff_stats *stat, int tag, void *p, size_t old, size_t size);
+/* Give_pages: Give for a large block */
+static void Give_pages(Biodiff_stats *stat, int tag, void *p, size_t size);
+/* Fail: record the message of an error and return BIODIFF_ERROR */
+static int Fail(Biodiff *bd, const char *format, ...);
+/* Report: pass a line to the log of the context */
+static void Report(Biodiff *bd, const char *format, ...);
+/* Open_rows: start a pass over the records of a table */
+static int Open_rows(Biodiff *bd, Biodiff_table *table, struct Cursor *cursor);
+/* Next_row: the next record of a pass, NULL at the end */
+static char *Next_row(struct Cursor *cursor);
+/* Close_rows: finish a pass, the number of rows is known after the first one */
+static int Close_rows(Biodiff *bd, struct Cursor *cursor);
+/* Batch_size: the keys of a batch, as the context says */
+static int Batch_size(Biodiff *bd);
+/* Next_batch: the next rows of a pass and their keys, as many as a batch holds; 0 at the end */
+static int Next_batch(Biodiff *bd, struct Cursor *cursor, struct Batch *batch);
+/* In_shard: whether a key belongs to the shard of the context in a mode */
+static int In_shard(Biodiff *bd, int mode, char *key);
+/* Check_shard: whether the shard of the context can be compared in a mode */
+static int Check_shard(Biodiff *bd, int mode);
+/* Mark_row: record whether a row has a match and pass it to the callback */
+static int Mark_row(Biodiff *bd, Biodiff_result *result, int side, long row, int matched, char *line);
+/* Table_index: the index of a table for a mode, built on the first call */
+static Index *Table_index(Biodiff *bd, Biodiff_table *table, int mode);
+/* Table_intervals: the sorted intervals of a table, stored on the first call */
+static struct Interval *Table_intervals(Biodiff *bd, Biodiff_table *table);
+/* Keep_intervals: sort the intervals of a table as their runs allow and keep them, with their ends apart */
+static struct Interval *Keep_intervals(Biodiff *bd, Biodiff_table *table, struct Interval *interval, long rows, long runs);
+/* Shard_intervals: keep the intervals reaching into the span of the shard of the context */
+static struct Interval *Shard_intervals(Biodiff *bd, Biodiff_table *table, struct Interval *interval, long *rows, int *close);
+/* Merge_runs: sort intervals made of runs already in order by merging the runs */
+static void Merge_runs(Biodiff *bd, struct Interval *interval, long rows, long runs);
+/* Open_reader: open a plain, gzip or BGZF input file, '-' for the standard input */
+static Reader *Open_reader(Biodiff *bd, const char *file_name);
+/* Fill: make the next decoded bytes ready */
+static size_t Fill(Reader *file);
+/* Read_line: read a line like fgets */
+static char *Read_line(char *line, int size, Reader *file);
+/* Read_rewind: move back to the start of the file */
+static void Read_rewind(Reader *file);
+/* Read_empty: whether nothing is left to read */
+static int Read_empty(Reader *file);
+/* Close_reader: close the file and release the reader */
+static void Close_reader(Reader *file);
+/* Create_pool: start a pool of threads */
+static Pool *Create_pool(int threads);
+/* Pool_for: run job(arg, i) for i from 0 to count-1 on the pool, serially without one */
+static void Pool_for(Pool *pool, void (*job)(void *arg, int i), void *arg, int count);
+/* Free_pool: stop the threads and release the pool */
+static void Free_pool(Pool *pool);
+/* Row_key: the key of the current row of a pass, from the columns of a columnar table */
+static char *Row_key(struct Cursor *cursor, char *key);
+/* Encode_key: the key of the current row from several columns or typed ones, in one string */
+static char *Encode_key(struct Cursor *cursor, char *key);
+/* Check_keys: whether the keys of n tables are made alike */
+static int Check_keys(Biodiff *bd, Biodiff_table **table, int n);
+/* Bottom_k: sort and unique the hashes of a buffer and keep the smallest BIODIFF_SKETCH_K */
+static long Bottom_k(uint64_t *hash, long n);
+/* Count_registers: the HyperLogLog estimate of the distinct keys of some registers */
+static double Count_registers(const unsigned char *reg);
+/* Ln: the natural logarithm, without libm */
+static double Ln(double x);
+/* Root: the square root, without libm */
+static double Root(double x);
+/* Fold_key: fold the case or drop the version suffix of a key, in the key buffer */
+static char *Fold_key(char *value, char *key, int fold);
+/* Map_columns: map a columnar file, *columns is NULL when the file is not one */
+static int Map_columns(Biodiff *bd, const char *file_name, struct Columns **columns);
+/* Check_column: whether the dictionary, ranks and order of a column stay inside their sections */
+static int Check_column(const unsigned char *map, const struct Column_header *column, int64_t rows);
+/* Unmap_columns: unmap a columnar file and release its decoded numbers */
+static void Unmap_columns(struct Columns *columns);
+/* Plain_source: whether a file holds exactly the bytes of a buffer, and its mtime */
+static int Plain_source(const char *file_name, const char *data, size_t len, int64_t *mtime);
+/* Column_value: the value of column c of a row of a columnar file, "" past the last column */
+static char *Column_value(struct Columns *columns, int c, long row);
+/* Column_numbers: the value of column c of every row as a number, decoded once */
+static int64_t *Column_numbers(struct Columns *columns, int c);
+/* Get_col: get a specific column from a line with separators according to c */
+static char *Get_col(char *line, char *col, char separator, int c);
+/* Region_span: the half-open span of the bins of two coordinates, both ends included */
+static void Region_span(long left, long right, int *begin, int *end);
+/* Region_bin: the smallest bin that holds a span */
+static int Region_bin(int begin, int end);
+/* Region_bins: the bins that may hold a record overlapping a span */
+static int Region_bins(int begin, int end, int *list);
+/* Cmp_chunk: the comparison function for qsort, by bin then by offset */
+static int Cmp_chunk(const void *a, const void *b);
+/* Map_regions: map the binned index of a file and check that it is up to date */
+static int Map_regions(Biodiff *bd, const char *file_name, struct Regions **regions);
+/* Read_chunks: the records of a file in the chunks, plain files read at their offsets */
+static char *Read_chunks(Biodiff *bd, const char *file_name, struct Region_chunk *chunk, long chunks, size_t *len);
+/* Mark_range: set the bits of a bitmap from from to to, to excluded */
+static void Mark_range(unsigned char *bits, long from, long to);
+/* Run_end: the first of start[from..to-1] greater than x, to when there is none */
+static long Run_end(const int *start, long from, long to, int x);
+#ifdef BIODIFF_X86
+/* Run_end_avx2: Run_end 8 at a time */
+static long Run_end_avx2(const int *start, long from, long to, int x);
+/* Run_end_avx512: Run_end 16 at a time */
+static long Run_end_avx512(const int *start, long from, long to, int x);
+#endif
+/* Cmp_coord: compare two coordinates as numbers or as strings */
+SPECIALIZE int Cmp_coord(int coord, const struct Interval *a, int end, const struct Interval *b);
+/* Cmp_interval: the comparison function for qsort, first the left end point then the right one */
+static int Cmp_interval(const void *a, const void *b);
+/* Cmp_int: the comparison function for qsort of numbers */
+static int Cmp_int(const void *a, const void *b);
+/* Cmp_int64: the comparison function for qsort of 64-bit numbers */
+static int Cmp_int64(const void *a, const void *b);
+/* Cmp_uint64: the comparison function for qsort of hashes */
+static int Cmp_uint64(const void *a, const void *b);
+/******************************************************************************/
+/* create a tire tree root, NULL when no chunk is left for it */
+static TrieNode *Create_tire(Biodiff *bd, struct Arena *arena)
+{
+    TrieNode *temp;
+    char *chunk;
+    if (!arena -> chunk || arena -> used + sizeof(TrieNode) > HUGE_PAGE)   /* a new chunk */
+    {
+        if (!(chunk = (char *) Take_pages(bd, arena -> stat, BIODIFF_MEM_INDEX, HUGE_PAGE)))
+        {
+            arena -> failed = 1;
+            return NULL;
+        }
+        *(char **) chunk = arena -> chunk;
+        arena -> chunk = chunk;
+        arena -> used = 64;                                /* the nodes start a cache line in */
+    }
+    temp = (TrieNode *) (arena -> chunk + arena -> used); /* apply for space */
+    arena -> used += sizeof(TrieNode);
+    temp -> exist = NOTEXIST;                              /* initialization */
+    for(int i = 0; i < BRANCH_SIZE; i++)                   /* initialization */
+        temp -> next[i] = NULL;
+    return temp;
+}
+/******************************************************************************/
+/* insert a node to the trie tree */
+static void Insert_trie(Biodiff *bd, struct Arena *arena, TrieNode * root, char *col)
+{
+    TrieNode *temp = root;
+    if (!temp)   /* the root was not taken, the arena has failed */
+        return;
+    for(int i; *col; col++)
+    {
+        i = *col;
+        if (temp -> next[i])           /* node existed already */
+            ;
+        else if (!(temp -> next[i] = Create_tire(bd, arena))) /* create a new node */
+            return;
+        temp = temp -> next[i];           /* point to next node */
+    }
+    temp -> exist = EXIST;               /* complete an insertion and record it */
+}
+
+/******************************************************************************/
+/* search for a string according to a trie tree based on total equal.*/
+static int Search_trie1(TrieNode *root, char *str)
+{
+    int i;
+    TrieNode *temp = root;
+    if (!temp)  /* tire tree must not be empty */
+        return 0;
+    for(int i; *str; str++)
+    {
+        i = *str;
+        if(temp -> next[i])    /* if a specific character exist, point to the next one*/
+            temp = temp -> next[i];
+        else           /* not match */
+            return 0;
+    }
+    if (temp -> exist)  /* match */
+        return EXIST;
+    else                /* include but not equal */
+        return NOTEXIST;
+}
+
+/******************************************************************************/
+/* create a radix tree root */
+static RadixNode *Create_radix(Biodiff_stats *stat)
+{
+    RadixNode *temp = (RadixNode *) Take(stat, BIODIFF_MEM_INDEX, sizeof(RadixNode)); /* apply for space */
+    temp -> exist = NOTEXIST;                                  /* initialization */
+    temp -> len = 0;
+    temp -> label = NULL;
+    temp -> nchild = temp -> size = 0;
+    temp -> child = NULL;
+    return temp;
+}
+
+/* add a child to a radix node */
+static void Add_radix(Biodiff_stats *stat, RadixNode *node, RadixNode *child)
+{
+    if (node -> nchild == node -> size)
+    {
+        node -> size = node -> size ? node -> size * 2 : 2;
+        node -> child = (RadixNode **) Retake(stat, BIODIFF_MEM_INDEX, node -> child,
+                                              sizeof(RadixNode *) * node -> nchild, sizeof(RadixNode *) * node -> size);
+    }
+    node -> child[node -> nchild++] = child;
+}
+
+/******************************************************************************/
+/* insert a string to the radix tree */
+static void Insert_radix(Biodiff_stats *stat, RadixNode *root, char *col)
+{
+    RadixNode *temp = root, *next, *mid;
+    int i, k;
+    while (*col)
+    {
+        for (i = 0; i < temp -> nchild; i++)  /* find the edge starting with *col */
+            if (temp -> child[i] -> label[0] == *col)
+                break;
+        if (i == temp -> nchild)              /* no edge: the rest of the string is a new leaf */
+        {
+            next = Create_radix(stat);
+            next -> len = strlen(col);
+            next -> label = (char *) Take(stat, BIODIFF_MEM_INDEX, next -> len);
+            memcpy(next -> label, col, next -> len);
+            next -> exist = EXIST;
+            Add_radix(stat, temp, next);
+            return;
+        }
+        next = temp -> child[i];
+        for (k = 1; k < next -> len && col[k] == next -> label[k]; k++)
+            ;                                 /* length of the shared run */
+        if (k < next -> len)                  /* split the edge at the end of the shared run */
+        {
+            mid = Create_radix(stat);
+            mid -> len = k;
+            mid -> label = (char *) Take(stat, BIODIFF_MEM_INDEX, k);
+            memcpy(mid -> label, next -> label, k);
+            next -> len -= k;
+            memmove(next -> label, next -> label + k, next -> len);
+            next -> label = (char *) Retake(stat, BIODIFF_MEM_INDEX, next -> label, next -> len + k, next -> len);
+            Add_radix(stat, mid, next);
+            temp -> child[i] = mid;
+            next = mid;
+        }
+        col += k;
+        temp = next;
+    }
+    temp -> exist = EXIST;                    /* complete an insertion and record it */
+}
+
+/******************************************************************************/
+/* freeze a radix tree into a contiguous breadth-first layout and release it */
+static RadixTree *Freeze_radix(Biodiff *bd, Biodiff_stats *stat, RadixNode *root)
+{
+    RadixTree *tree = (RadixTree *) Take(stat, BIODIFF_MEM_INDEX, sizeof(RadixTree));
+    RadixNode **queue = (RadixNode **) Take(stat, BIODIFF_MEM_INDEX, sizeof(RadixNode *));
+    int size = 1, tail = 1, i, j, labels = 0, used = 0;
+    queue[0] = root;
+    for (i = 0; i < tail; i++)                /* breadth-first: the children of a node get adjacent slots */
+    {
+        if (tail + queue[i] -> nchild > size)
+        {
+            j = size;
+            while (tail + queue[i] -> nchild > size)
+                size *= 2;
+            queue = (RadixNode **) Retake(stat, BIODIFF_MEM_INDEX, queue, sizeof(RadixNode *) * j, sizeof(RadixNode *) * size);
+        }
+        for (j = 0; j < queue[i] -> nchild; j++)
+            queue[tail++] = queue[i] -> child[j];
+        labels += queue[i] -> len;
+    }
+    tree -> nodes = tail;
+    tree -> length = labels;
+    tree -> slot = (struct RadixSlot *) Take_pages(bd, stat, BIODIFF_MEM_INDEX, sizeof(struct RadixSlot) * tail);
+    tree -> key = (unsigned char *) Take_pages_zero(bd, stat, BIODIFF_MEM_INDEX, tail + RADIX_WIDTH, 1); /* padded for whole-width loads */
+    tree -> labels = (char *) Take_pages(bd, stat, BIODIFF_MEM_INDEX, labels + 1);
+    for (i = 0, j = 1; i < tail; i++)
+    {
+        tree -> slot[i].label = used;
+        tree -> slot[i].len = queue[i] -> len;
+        tree -> slot[i].first = j;
+        tree -> slot[i].nchild = queue[i] -> nchild;
+        tree -> slot[i].exist = queue[i] -> exist;
+        tree -> key[i] = queue[i] -> len ? (unsigned char) queue[i] -> label[0] : 0;
+        if (queue[i] -> len)
+            memcpy(tree -> labels + used, queue[i] -> label, queue[i] -> len);
+        used += queue[i] -> len;
+        j += queue[i] -> nchild;
+        Give(stat, BIODIFF_MEM_INDEX, queue[i] -> label, queue[i] -> len);   /* release the build-time node */
+        Give(stat, BIODIFF_MEM_INDEX, queue[i] -> child, sizeof(RadixNode *) * queue[i] -> size);
+        Give(stat, BIODIFF_MEM_INDEX, queue[i], sizeof(RadixNode));
+    }
+    Give(stat, BIODIFF_MEM_INDEX, queue, sizeof(RadixNode *) * size);
+    return tree;
+}
+
+/* find the child of a frozen node whose label starts with c */
+static int Find_radix(RadixTree *tree, struct RadixSlot *node, unsigned char c)
+{
+    int i;
+#ifdef __SSE2__
+    __m128i needle = _mm_set1_epi8((char) c);
+    for (i = 0; i < node -> nchild; i += RADIX_WIDTH)
+    {
+        __m128i keys = _mm_loadu_si128((__m128i *) (tree -> key + node -> first + i));
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(keys, needle));
+        if (node -> nchild - i < RADIX_WIDTH)
+            mask &= (1u << (node -> nchild - i)) - 1;  /* ignore keys of the following nodes */
+        if (mask)
+            return node -> first + i + __builtin_ctz(mask);
+    }
+#else
+    for (i = 0; i < node -> nchild; i++)
+        if (tree -> key[node -> first + i] == c)
+            return node -> first + i;
+#endif
+    return -1;
+}
+
+/******************************************************************************/
+/* search for a string according to a radix tree based on prefix */
+static int Search_radix(RadixTree *tree, char *str)
+{
+    struct RadixSlot *temp = tree -> slot;
+    char *label;
+    int next, k;
+    while (*str)
+    {
+        if ((next = Find_radix(tree, temp, (unsigned char) *str)) < 0)
+            return NOTEXIST;                  /* not match */
+        temp = tree -> slot + next;
+        label = tree -> labels + temp -> label;
+        for (k = 1; k < temp -> len && str[k]; k++)
+            if (str[k] != label[k])
+                return NOTEXIST;              /* not match inside the label run */
+        if (k < temp -> len)
+            return EXIST;                     /* the string ends inside the label run */
+        str += k;
+    }
+    return EXIST;      /* include */
+}
+
+/******************************************************************************/
+/* search for the keys of a radix tree within approx -> k edits of a string.
+   The rows of the edit distances between the string and the path from the root
+   are computed a label byte at a time, only the 2k + 1 entries of a row that can
+   stay within k, and a branch is left once a whole row is over k. Once the least
+   entry is k no edit is left, and the rest of the string is followed exactly
+   from every entry of k. So a key visits the nodes near it only, not every key. */
+static int Search_approx(struct Approx *approx, char *str)
+{
+    int j, k = approx -> k;
+    approx -> key = str;
+    approx -> len = strlen(str);
+    if ((long) (approx -> len + k + 1) * (approx -> len + 1) > approx -> size)
+    {
+        approx -> rows = (int *) Retake(approx -> stat, BIODIFF_MEM_ARRAYS, approx -> rows, sizeof(int) * approx -> size,
+                                        sizeof(int) * (approx -> len + k + 1) * (approx -> len + 1));
+        approx -> size = (long) (approx -> len + k + 1) * (approx -> len + 1);   /* a row for every depth up to len + k */
+    }
+    for (j = 0; j <= approx -> len; j++)
+        approx -> rows[j] = j <= k ? j : k + 1;   /* the string against the empty path */
+    if (!k)
+        return Exact_approx(approx, 0, 0, 0);
+    if (approx -> tree -> slot -> exist && approx -> len <= k)
+        return EXIST;      /* the empty key */
+    return Walk_approx(approx, 0, 0);
+}
+
+/* walk the children of a radix node, the row of the node at depth */
+static int Walk_approx(struct Approx *approx, int slot, int depth)
+{
+    struct RadixSlot *node = approx -> tree -> slot + slot, *child;
+    char *label;
+    int *prev, *cur = NULL, c, i, j, d, lo, hi, low, v, k = approx -> k, w = approx -> len + 1;
+    for (c = node -> first; c < node -> first + node -> nchild; c++)
+    {
+        child = approx -> tree -> slot + c;
+        label = approx -> tree -> labels + child -> label;
+        approx -> nodes++;
+        for (i = 0, d = depth; i < child -> len; i++)
+        {
+            d++;
+            lo = d - k > 1 ? d - k : 1;           /* the band of the row that can stay within k */
+            hi = d + k < approx -> len ? d + k : approx -> len;
+            if (lo > hi && lo > 1)
+                break;                            /* longer than the string by more than k */
+            prev = approx -> rows + (long) (d - 1) * w;
+            cur = prev + w;
+            low = cur[lo - 1] = lo > 1 || d > k ? k + 1 : d;
+            for (j = lo; j <= hi; j++)
+            {
+                v = prev[j - 1] + (approx -> key[j - 1] != label[i]);   /* substitution */
+                if (prev[j] + 1 < v)
+                    v = prev[j] + 1;              /* insertion */
+                if (cur[j - 1] + 1 < v)
+                    v = cur[j - 1] + 1;           /* deletion */
+                cur[j] = v > k ? k + 1 : v;
+                if (cur[j] < low)
+                    low = cur[j];
+            }
+            if (hi < approx -> len)
+                cur[hi + 1] = k + 1;              /* read by the next row */
+            if (low > k)
+                break;                            /* every path below is over k */
+            if (low == k)
+            {
+                for (j = lo - 1; j <= hi; j++)    /* no edit left */
+                    if (cur[j] == k && Exact_approx(approx, c, i + 1, j))
+                        return EXIST;
+                break;
+            }
+        }
+        if (i < child -> len)
+            continue;                             /* the paths below are done */
+        if (child -> exist && d + k >= approx -> len && cur[approx -> len] <= k)
+            return EXIST;
+        if (Walk_approx(approx, c, d))
+            return EXIST;
+    }
+    return NOTEXIST;
+}
+
+/* follow the rest of the string from entry j exactly, from byte at of the label of a node */
+static int Exact_approx(struct Approx *approx, int slot, int at, int j)
+{
+    struct RadixSlot *node = approx -> tree -> slot + slot;
+    const char *str = approx -> key + j, *label = approx -> tree -> labels + node -> label;
+    for (;;)
+    {
+        for (; at < node -> len; at++, str++)
+            if (*str != label[at])
+                return NOTEXIST;                  /* also when the string ends inside the label */
+        if (!*str)
+            return node -> exist;
+        approx -> nodes++;
+        if ((slot = Find_radix(approx -> tree, node, (unsigned char) *str)) < 0)
+            return NOTEXIST;
+        node = approx -> tree -> slot + slot;
+        label = approx -> tree -> labels + node -> label;
+        at = 0;
+    }
+}
+
+/******************************************************************************/
+/* release a frozen radix tree */
+static void Free_radix(Biodiff_stats *stat, RadixTree *tree)
+{
+    Give_pages(stat, BIODIFF_MEM_INDEX, tree -> slot, sizeof(struct RadixSlot) * tree -> nodes);
+    Give_pages(stat, BIODIFF_MEM_INDEX, tree -> key, tree -> nodes + RADIX_WIDTH);
+    Give_pages(stat, BIODIFF_MEM_INDEX, tree -> labels, tree -> length + 1);
+    Give(stat, BIODIFF_MEM_INDEX, tree, sizeof(RadixTree));
+}
+
+/* release a radix tree that was not frozen, when building its index failed */
+static void Drop_radix(Biodiff_stats *stat, RadixNode *node)
+{
+    for (int i = 0; i < node -> nchild; i++)
+        Drop_radix(stat, node -> child[i]);
+    Give(stat, BIODIFF_MEM_INDEX, node -> label, node -> len);
+    Give(stat, BIODIFF_MEM_INDEX, node -> child, sizeof(RadixNode *) * node -> size);
+    Give(stat, BIODIFF_MEM_INDEX, node, sizeof(RadixNode));
+}
+
+/******************************************************************************/
+/* Biodiff_create: create a context with options, NULL for the defaults */
+Biodiff *Biodiff_create(const Biodiff_options *options)
+{
+    Biodiff *bd = (Biodiff *) calloc(1, sizeof(Biodiff));
+    if (options)
+        bd -> opt = *options;
+    if (!bd -> opt.coord)
+        bd -> opt.coord = BIODIFF_COORD_INT;
+    if (bd -> opt.threads > 1)
+        bd -> workers = Create_pool(bd -> opt.threads);
+    bd -> run_end = Run_end;
+#ifdef BIODIFF_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        bd -> run_end = Run_end_avx512;
+    else if (__builtin_cpu_supports("avx2"))
+        bd -> run_end = Run_end_avx2;
+#endif
+    bd -> phase = -1;
+    if (bd -> opt.perf)
+        Perf_open(bd);
+    return bd;
+}
+
+/******************************************************************************/
+/* Biodiff_free: stop the threads of a context and release it */
+void Biodiff_free(Biodiff *bd)
+{
+    if (bd -> workers)
+        Free_pool(bd -> workers);
+    while (bd -> perf_n)
+        close(bd -> perf_fd[--bd -> perf_n]);
+    free(bd);
+}
+
+/******************************************************************************/
+/* Perf_open: open the hardware counters of opt.perf on the calling thread, in one group
+   so that they count together. An event that can not be opened is left out and its
+   counts are -1, as all of them are where perf_event_open is missing or not allowed. */
+static void Perf_open(Biodiff *bd)
+{
+    int e, p;
+#ifdef __linux__
+    static const uint32_t type[BIODIFF_EVENTS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+    static const uint64_t config[BIODIFF_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_LL | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16,
+        PERF_COUNT_HW_CACHE_DTLB | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16,
+        PERF_COUNT_HW_BRANCH_MISSES};
+    struct perf_event_attr attr;
+    int fd;
+    for (e = 0; e < BIODIFF_EVENTS; e++)
+    {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type[e];
+        attr.config = config[e];
+        attr.exclude_kernel = attr.exclude_hv = 1;   /* allowed with perf_event_paranoid 2 */
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fd = syscall(__NR_perf_event_open, &attr, 0, -1, bd -> perf_n ? bd -> perf_fd[0] : -1, 0);
+        if (fd >= 0)
+        {
+            bd -> perf_fd[bd -> perf_n] = fd;
+            bd -> perf_event[bd -> perf_n++] = e;
+            continue;
+        }
+        for (p = 0; p < BIODIFF_PHASES; p++)
+            bd -> stat.perf[p][e] = -1;
+    }
+#else
+    for (e = 0; e < BIODIFF_EVENTS; e++)
+        for (p = 0; p < BIODIFF_PHASES; p++)
+            bd -> stat.perf[p][e] = -1;
+#endif
+}
+
+/* Perf_phase: charge the events since the last change of phase to the phase left and
+   enter another, -1 for none; the phase left is returned to be entered again. The
+   counts are scaled up when the kernel had to share the counters with other groups. */
+static int Perf_phase(Biodiff *bd, int phase)
+{
+    uint64_t value[3 + BIODIFF_EVENTS];   /* counters, time enabled, time running, the counts */
+    long long count;
+    int left = bd -> phase, i;
+    if (!bd -> perf_n || phase == left)
+        return left;
+    if (read(bd -> perf_fd[0], value, sizeof(uint64_t) * (3 + bd -> perf_n)) > 0 && value[2])
+        for (i = 0; i < bd -> perf_n; i++)
+        {
+            count = (long long) ((double) value[3 + i] * value[1] / value[2]);
+            if (left >= 0)
+                bd -> stat.perf[left][bd -> perf_event[i]] += count - bd -> perf_last[i];
+            bd -> perf_last[i] = count;
+        }
+    bd -> phase = phase;
+    return left;
+}
+
+/******************************************************************************/
+/* Biodiff_error: the message of the last error of a context */
+const char *Biodiff_error(Biodiff *bd)
+{
+    return bd -> error;
+}
+
+/******************************************************************************/
+/* Biodiff_get_stats: the counters of a context */
+const Biodiff_stats *Biodiff_get_stats(Biodiff *bd)
+{
+    return &bd -> stat;
+}
+
+/******************************************************************************/
+/* Biodiff_set_log: receive the lines a context reports, e.g. the plan */
+void Biodiff_set_log(Biodiff *bd, void (*log)(void *arg, const char *line), void *arg)
+{
+    bd -> log = log;
+    bd -> log_arg = arg;
+}
+
+/******************************************************************************/
+/* Fail: record the message of an error and return BIODIFF_ERROR */
+static int Fail(Biodiff *bd, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vsnprintf(bd -> error, LINE_BUFFER, format, args);
+    va_end(args);
+    return BIODIFF_ERROR;
+}
+
+/******************************************************************************/
+/* Report: pass a line to the log of the context */
+static void Report(Biodiff *bd, const char *format, ...)
+{
+    char line[LINE_BUFFER];
+    va_list args;
+    if (!bd -> log)
+        return;
+    va_start(args, format);
+    vsnprintf(line, LINE_BUFFER, format, args);
+    va_end(args);
+    bd -> log(bd -> log_arg, line);
+}
+
+/******************************************************************************/
+/* Account: charge bytes and blocks to a kind of memory, negative to release them.
+   The allocations of a context are all made by the thread calling it, so the
+   counters need no lock; a NULL stats charges nothing. */
+static void Account(Biodiff_stats *stat, int tag, long long bytes, long blocks)
+{
+    Biodiff_memory *memory;
+    long long total = 0;
+    int t;
+    if (!stat)
+        return;
+    memory = stat -> memory + tag;
+    memory -> bytes += bytes;
+    memory -> blocks += blocks;
+    if (memory -> bytes > memory -> peak)
+        memory -> peak = memory -> bytes;
+    if (memory -> blocks > memory -> peak_blocks)
+        memory -> peak_blocks = memory -> blocks;
+    for (t = 0; t < BIODIFF_MEM_TAGS; t++)
+        total += stat -> memory[t].bytes;
+    if (total > stat -> memory_peak)
+        stat -> memory_peak = total;
+}
+
+/* Take: malloc charged to a kind of memory, nothing charged for NULL */
+static void *Take(Biodiff_stats *stat, int tag, size_t size)
+{
+    void *p = malloc(size);
+    if (p)
+        Account(stat, tag, size, 1);
+    return p;
+}
+
+/* Take_zero: calloc charged to a kind of memory, nothing charged for NULL */
+static void *Take_zero(Biodiff_stats *stat, int tag, size_t n, size_t size)
+{
+    void *p = calloc(n, size);
+    if (p)
+        Account(stat, tag, (long long) n * size, 1);
+    return p;
+}
+
+/* Retake: realloc charged to a kind of memory, the old size given, 0 for a new block;
+   nothing charged for NULL, when the old block is kept */
+static void *Retake(Biodiff_stats *stat, int tag, void *p, size_t old, size_t size)
+{
+    void *q = realloc(p, size);
+    if (q)
+        Account(stat, tag, (long long) size - (long long) old, p ? 0 : 1);
+    return q;
+}
+
+/* Give: free charged to a kind of memory, the size given; NULL releases nothing */
+static void Give(Biodiff_stats *stat, int tag, void *p, size_t size)
+{
+    if (!p)
+        return;
+    Account(stat, tag, -(long long) size, -1);
+    free(p);
+}
+
+/******************************************************************************/
+/* Map_pages: map size bytes, whole huge pages, aligned to a huge page. With
+   BIODIFF_HUGE_TLB they come from the reserved huge pages while any are left,
+   else they are advised for transparent huge pages with BIODIFF_HUGE_THP or
+   BIODIFF_HUGE_TLB; with BIODIFF_NUMA_INTERLEAVE the pages are spread over every
+   node the process may use, so that threads on all of them share the misses. */
+static void *Map_pages(Biodiff *bd, size_t size)
+{
+    char *p = MAP_FAILED, *at;
+#ifdef MAP_HUGETLB
+    if (bd -> opt.huge_pages == BIODIFF_HUGE_TLB &&
+        (p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0)) != MAP_FAILED)
+        bd -> stat.page_hugetlb++;
+#endif
+    if (p == MAP_FAILED)
+    {
+        if ((p = mmap(NULL, size + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED)
+            return NULL;
+        at = (char *) PAGES((uintptr_t) p);   /* cut to a huge page boundary */
+        if (at > p)
+            munmap(p, at - p);
+        munmap(at + size, p + HUGE_PAGE - at);
+        p = at;
+#ifdef MADV_HUGEPAGE
+        if (bd -> opt.huge_pages)
+            madvise(p, size, MADV_HUGEPAGE);
+#endif
+    }
+#if defined(__linux__) && defined(SYS_mbind)
+    if (bd -> opt.numa == BIODIFF_NUMA_INTERLEAVE)
+    {
+        unsigned long nodes[16] = {0};
+        if (!syscall(SYS_get_mempolicy, NULL, nodes, 64 * 16, NULL, MPOL_F_MEMS_ALLOWED))
+            syscall(SYS_mbind, p, size, MPOL_INTERLEAVE, nodes, 64 * 16, 0);
+    }
+#endif
+    bd -> stat.page_regions++;
+    return p;
+}
+
+/* Take_pages: Take for a large block, mapped from huge pages from HUGE_PAGE bytes on;
+   nothing charged for NULL */
+static void *Take_pages(Biodiff *bd, Biodiff_stats *stat, int tag, size_t size)
+{
+    void *p;
+    if (size < HUGE_PAGE)
+        return Take(stat, tag, size);
+    if ((p = Map_pages(bd, PAGES(size))))
+        Account(stat, tag, size, 1);
+    return p;
+}
+
+/* Take_pages_zero: Take_zero for a large block, the pages of a new mapping are zero */
+static void *Take_pages_zero(Biodiff *bd, Biodiff_stats *stat, int tag, size_t n, size_t size)
+{
+    if (n * size < HUGE_PAGE)
+        return Take_zero(stat, tag, n, size);
+    return Take_pages(bd, stat, tag, n * size);
+}
+
+/* Retake_pages: Retake for a large block. A mapping is cut in place, and moved
+   when it grows, so that it keeps its placement */
+static void *Retake_pages(Biodiff *bd, Biodiff_stats *stat, int tag, void *p, size_t old, size_t size)
+{
+    void *q;
+    if (old < HUGE_PAGE && size < HUGE_PAGE)
+        return Retake(stat, tag, p, old, size);
+    if (old >= HUGE_PAGE && size >= HUGE_PAGE && PAGES(size) <= PAGES(old))
+    {
+        if (PAGES(size) < PAGES(old))
+            munmap((char *) p + PAGES(size), PAGES(old) - PAGES(size));
+        Account(stat, tag, (long long) size - (long long) old, 0);
+        return p;
+    }
+    if (!(q = Take_pages(bd, stat, tag, size)))
+        return NULL;   /* the old block is kept, like realloc */
+    if (p)
+        memcpy(q, p, old < size ? old : size);
+    Give_pages(stat, tag, p, old);
+    return q;
+}
+
+/* Give_pages: Give for a large block */
+static void Give_pages(Biodiff_stats *stat, int tag, void *p, size_t size)
+{
+    if (!p || size < HUGE_PAGE)
+    {
+        Give(stat, tag, p, size);
+        return;
+    }
+    Account(stat, tag, -(long long) size, -1);
+    munmap(p, PAGES(size));
+}
+
+/* Create_table: an empty table with its key columns, NULL when it can not be taken */
+static Biodiff_table *Create_table(Biodiff *bd, const int *col)
+{
+    Biodiff_table *table = (Biodiff_table *) calloc(1, sizeof(Biodiff_table));
+    if (!table)
+    {
+        Fail(bd, "Can not take a table.");
+        return NULL;
+    }
+    table -> stat = &bd -> stat;
+    for (; table -> keys < BIODIFF_MAX_KEY && col[table -> keys]; table -> keys++)
+    {
+        table -> col[table -> keys] = col[table -> keys] & 0xffff;
+        table -> type[table -> keys] = col[table -> keys] & (BIODIFF_KEY_INT | BIODIFF_KEY_FOLD);
+    }
+    table -> rows = -1;
+    return table;
+}
+
+/******************************************************************************/
+/* Biodiff_table_file: a table of a plain, gzip, BGZF or columnar file, "-" for the standard input.
+   A columnar file is mapped: its text is read as a buffer and its keys need no parsing. */
+Biodiff_table *Biodiff_table_file(Biodiff *bd, const char *file_name, const int *col)
+{
+    Biodiff_table *table;
+    struct Columns *columns;
+    Reader *file;
+    if (Map_columns(bd, file_name, &columns))
+        return NULL;
+    if (columns)
+    {
+        if (!(table = Create_table(bd, col)))
+        {
+            Unmap_columns(columns);
+            return NULL;
+        }
+        table -> columns = columns;
+        table -> data = columns -> text;
+        table -> size = columns -> head -> text_size;
+        table -> offset = (int64_t *) (columns -> map + columns -> head -> line);
+        table -> rows = columns -> head -> rows;
+        return table;
+    }
+    if (!(file = Open_reader(bd, file_name)))
+    {
+        Fail(bd, "Can not open the input file %s.", file_name);
+        return NULL;
+    }
+    if (file -> error)
+    {
+        Close_reader(file);
+        Fail(bd, "Can not decompress the input file %s.", file_name);
+        return NULL;
+    }
+    if (!(table = Create_table(bd, col)))
+    {
+        Close_reader(file);
+        return NULL;
+    }
+    table -> reader = file;
+    return table;
+}
+
+/******************************************************************************/
+/* Biodiff_table_buffer: a table of the lines in a buffer, which must outlive the table.
+   The buffer is cut into records once, as Read_line would cut it. */
+Biodiff_table *Biodiff_table_buffer(Biodiff *bd, const char *data, size_t len, const int *col)
+{
+    Biodiff_table *table = Create_table(bd, col);
+    const char *end;
+    size_t pos, k;
+    long size = 1024;
+    if (!table)
+        return NULL;
+    table -> data = data;
+    table -> size = len;
+    table -> offset = (int64_t *) Take(table -> stat, BIODIFF_MEM_ARRAYS, sizeof(int64_t) * size);
+    for (pos = table -> rows = 0; pos < len; pos += k)
+    {
+        k = len - pos < LINE_BUFFER - 1 ? len - pos : LINE_BUFFER - 1;
+        if ((end = memchr(data + pos, '\n', k)))
+            k = end - (data + pos) + 1;
+        if (data[pos] == '\n')
+            continue;   /* skip the empty lines */
+        if (table -> rows == size)
+        {
+            table -> offset = (int64_t *) Retake(table -> stat, BIODIFF_MEM_ARRAYS, table -> offset, sizeof(int64_t) * size, sizeof(int64_t) * size * 2);
+            size *= 2;
+        }
+        table -> offset[table -> rows++] = pos;
+    }
+    /* cut to the rows, so that the table knows the size of its offsets when it is released */
+    table -> offset = (int64_t *) Retake(table -> stat, BIODIFF_MEM_ARRAYS, table -> offset, sizeof(int64_t) * size, sizeof(int64_t) * (table -> rows + 1));
+    return table;
+}
+
+/******************************************************************************/
+/* Biodiff_load: read a whole plain, gzip, BGZF or columnar file into memory for Biodiff_table_buffer */
+char *Biodiff_load(Biodiff *bd, const char *file_name, size_t *len)
+{
+    struct Columns *columns;
+    Reader *file;
+    char *data = NULL;
+    size_t size = 0;
+    if (Map_columns(bd, file_name, &columns))
+        return NULL;
+    if (columns)   /* the text of a columnar file */
+    {
+        *len = columns -> head -> text_size;
+        data = (char *) malloc(*len + 1);
+        memcpy(data, columns -> text, *len);
+        Unmap_columns(columns);
+        return data;
+    }
+    if (!(file = Open_reader(bd, file_name)))
+    {
+        Fail(bd, "Can not open the input file %s.", file_name);
+        return NULL;
+    }
+    for (*len = 0; Fill(file); *len += file -> len)
+    {
+        if (*len + file -> len > size)
+        {
+            while (*len + file -> len > size)
+                size = size ? size * 2 : READ_CHUNK;
+            data = (char *) realloc(data, size);
+        }
+        memcpy(data + *len, file -> data, file -> len);
+    }
+    if (file -> error)
+    {
+        free(data);
+        data = NULL;
+        Fail(bd, "Can not decompress the input file %s.", file_name);
+    }
+    else if (!data)
+        data = (char *) malloc(1);   /* an empty file */
+    Close_reader(file);
+    return data;
+}
+
+/******************************************************************************/
+/* Biodiff_load_from: read the complete lines of a file after its first offset bytes, decoded,
+   for Biodiff_table_buffer. A plain file is read from offset on, a compressed one decoded from
+   its start; a last line without its newline may still be written, it is left for a later call. */
+char *Biodiff_load_from(Biodiff *bd, const char *file_name, size_t offset, size_t *len)
+{
+    struct Columns *columns;
+    Reader *file;
+    char *data = NULL;
+    size_t size = 0, skip = offset, k;
+    unsigned char *from;
+    int error = 0;
+    if (Map_columns(bd, file_name, &columns))
+        return NULL;
+    if (columns)   /* a columnar file is not appended to, its text is whole */
+    {
+        k = offset < (size_t) columns -> head -> text_size ? offset : columns -> head -> text_size;
+        *len = columns -> head -> text_size - k;
+        data = (char *) malloc(*len + 1);
+        memcpy(data, columns -> text + k, *len);
+        Unmap_columns(columns);
+        skip -= k;
+    }
+    else if (!(file = Open_reader(bd, file_name)))
+    {
+        Fail(bd, "Can not open the input file %s.", file_name);
+        return NULL;
+    }
+    else
+    {
+        if (file -> format == FORMAT_PLAIN && file -> seekable && offset <= file -> size)
+        {
+            lseek(file -> fd, offset, SEEK_SET);   /* the bytes read to tell the format are dropped */
+            file -> raw_len = file -> raw_pos = 0;
+            file -> eof = 0;
+            skip = 0;
+        }
+        for (*len = 0; Fill(file); *len += k)
+        {
+            from = file -> data;
+            k = file -> len;
+            if (skip)   /* the decoded bytes before offset */
+            {
+                from += k < skip ? k : skip;
+                k -= from - file -> data;
+                skip -= from - file -> data;
+                if (!k)
+                    continue;
+            }
+            if (*len + k > size)
+            {
+                while (*len + k > size)
+                    size = size ? size * 2 : READ_CHUNK;
+                data = (char *) realloc(data, size);
+            }
+            memcpy(data + *len, from, k);
+        }
+        error = file -> error;
+        Close_reader(file);
+    }
+    if (error || skip)
+    {
+        free(data);
+        if (error)
+            Fail(bd, "Can not decompress the input file %s.", file_name);
+        else
+            Fail(bd, "The file %s is shorter than %lu bytes, it was not only appended to.", file_name, (unsigned long) offset);
+        return NULL;
+    }
+    for (k = *len; k && data[k - 1] != '\n'; k--)
+        ;   /* up to the last newline */
+    *len = k;
+    return data ? data : (char *) malloc(1);
+}
+
+/******************************************************************************/
+/* Biodiff_table_source: a table of the records of an iterator */
+Biodiff_table *Biodiff_table_source(Biodiff *bd, const Biodiff_source *source, const int *col)
+{
+    Biodiff_table *table = Create_table(bd, col);
+    if (table)
+        table -> source = *source;
+    return table;
+}
+
+/******************************************************************************/
+/* Biodiff_table_empty: whether a table has no record, a source that can not
+   be read again is never reported empty; a file that can not be decoded is an error */
+int Biodiff_table_empty(Biodiff *bd, Biodiff_table *table)
+{
+    struct Cursor cursor;
+    int empty;
+    if (table -> reader)
+    {
+        empty = Read_empty(table -> reader);
+        return table -> reader -> error ? Fail(bd, "Can not decompress the input files.") : empty;
+    }
+    if (table -> data)
+        return !table -> size;
+    if (!table -> source.rewind || Open_rows(bd, table, &cursor))
+        return 0;
+    return !Next_row(&cursor);
+}
+
+/******************************************************************************/
+/* Biodiff_table_prepare: build the index of a table for a mode now, to reuse it in later calls */
+int Biodiff_table_prepare(Biodiff *bd, Biodiff_table *table, int mode)
+{
+    int status;
+    Perf_phase(bd, BIODIFF_PHASE_READ);
+    if (mode == BIODIFF_APPROX)
+        mode = BIODIFF_PREFIX;   /* [-na] walks the radix tree of [-no] */
+    if (mode == BIODIFF_OVERLAP)
+        status = Table_intervals(bd, table) ? BIODIFF_OK : BIODIFF_ERROR;
+    else if (mode != BIODIFF_EQUAL && mode != BIODIFF_PREFIX)
+        status = Fail(bd, "Unknown mode %d.", mode);
+    else
+        status = Table_index(bd, table, mode) ? BIODIFF_OK : BIODIFF_ERROR;
+    Perf_phase(bd, -1);
+    return status;
+}
+
+/******************************************************************************/
+/* Biodiff_table_free: release a table and its indices */
+void Biodiff_table_free(Biodiff_table *table)
+{
+    long i;
+    for (i = 1; i < 3; ++i)
+        if (table -> index[i])
+            Index_free(table -> index[i]);
+    if (table -> interval)
+    {
+        for (i = 1; !table -> columns && i <= table -> intervals; ++i)
+            if (table -> interval[i].row)   /* not the one closing a shard */
+                Give(table -> stat, BIODIFF_MEM_STRINGS, table -> interval[i].start,
+                     strlen(table -> interval[i].start) + strlen(table -> interval[i].end) + 2);
+        Give_pages(table -> stat, BIODIFF_MEM_ARRAYS, table -> interval, sizeof(struct Interval) * (table -> intervals + 1));
+        Give_pages(table -> stat, BIODIFF_MEM_ARRAYS, table -> left, sizeof(int) * (table -> intervals + 1));
+        Give_pages(table -> stat, BIODIFF_MEM_ARRAYS, table -> right, sizeof(int) * (table -> intervals + 1));
+    }
+    if (table -> reader)
+        Close_reader(table -> reader);
+    if (table -> columns)
+        Unmap_columns(table -> columns);   /* the offsets are in the mapping */
+    else
+        Give(table -> stat, BIODIFF_MEM_ARRAYS, table -> offset, sizeof(int64_t) * (table -> rows + 1));
+    Give(table -> stat, BIODIFF_MEM_IO, table -> held, table -> size + 1);
+    free(table);
+}
+
+/******************************************************************************/
+/* Open_rows: start a pass over the records of a table */
+static int Open_rows(Biodiff *bd, Biodiff_table *table, struct Cursor *cursor)
+{
+    cursor -> table = table;
+    cursor -> row = cursor -> count = 0;
+    cursor -> at = cursor -> next = 0;
+    cursor -> fold = bd -> opt.fold;
+    cursor -> shard = cursor -> long_key = 0;
+    if (table -> data)
+        return BIODIFF_OK;   /* a buffer is only read, so passes may run at once */
+    if (table -> reader)
+        Read_rewind(table -> reader);
+    else if (table -> passes && (!table -> source.rewind || table -> source.rewind(table -> source.arg)))
+        return Fail(bd, "Can not read the records of a source again.");
+    table -> passes++;
+    return BIODIFF_OK;
+}
+
+/******************************************************************************/
+/* Next_row: the next record of a pass, NULL at the end */
+static char *Next_row(struct Cursor *cursor)
+{
+    Biodiff_table *table = cursor -> table;
+    const char *record, *end;
+    size_t len;
+    do
+    {
+        if (table -> reader)
+        {
+            if (!Read_line(cursor -> line, LINE_BUFFER, table -> reader))
+                return NULL;
+            cursor -> at = cursor -> next;
+            cursor -> next += strlen(cursor -> line);
+            continue;
+        }
+        if (table -> data)
+        {
+            if (cursor -> row == table -> rows)
+                return NULL;
+            cursor -> at = table -> offset[cursor -> row++];
+            record = table -> data + cursor -> at;
+            len = table -> data + table -> size - record;
+            if (len > LINE_BUFFER - 1)
+                len = LINE_BUFFER - 1;
+            if ((end = memchr(record, '\n', len)))
+                len = end - record + 1;
+        }
+        else if (!(record = table -> source.next(table -> source.arg, &len)))
+            return NULL;
+        else if (len > LINE_BUFFER - 1)
+            len = LINE_BUFFER - 1;   /* a buffer record is cut already: a known bound would inline a slow copy */
+        memcpy(cursor -> line, record, len);
+        cursor -> line[len] = 0;
+    }
+    while (*cursor -> line == '\n' || !*cursor -> line);   /* skip the empty lines */
+    cursor -> count++;
+    return cursor -> line;
+}
+
+/******************************************************************************/
+/* Close_rows: finish a pass, the number of rows is known after the first one */
+static int Close_rows(Biodiff *bd, struct Cursor *cursor)
+{
+    Biodiff_table *table = cursor -> table;
+    if (table -> reader && table -> reader -> error)
+        return Fail(bd, "Can not decompress the input files.");
+    if (cursor -> long_key)
+        return Fail(bd, "A key of the columns takes more than %d bytes.", KEY_SIZE - 1);
+    if (table -> rows < 0)
+        table -> rows = cursor -> count;
+    return BIODIFF_OK;
+}
+
+/******************************************************************************/
+/* Batch_size: the keys of a batch, as the context says */
+static int Batch_size(Biodiff *bd)
+{
+    return bd -> opt.batch < 1 ? PROBE_DEFAULT : bd -> opt.batch < PROBE_BATCH ? bd -> opt.batch : PROBE_BATCH;
+}
+
+/* Next_batch: the next rows of a pass and their keys, as many as a batch holds; 0 at the end.
+   A row outside the shard of the context has a NULL key, neither inserted nor found */
+static int Next_batch(Biodiff *bd, struct Cursor *cursor, struct Batch *batch)
+{
+    Perf_phase(bd, BIODIFF_PHASE_READ);
+    for (batch -> n = 0; batch -> n < Batch_size(bd) && Next_row(cursor); batch -> n++)
+    {
+        batch -> key[batch -> n] = Row_key(cursor, batch -> column[batch -> n]);
+        if (cursor -> shard && bd -> opt.shards > 1 && !In_shard(bd, cursor -> shard, batch -> key[batch -> n]))
+            batch -> key[batch -> n] = NULL;
+        strcpy(batch -> line[batch -> n], cursor -> line);
+    }
+    return batch -> n;
+}
+
+/******************************************************************************/
+/* Mark_row: record whether a row has a match and pass it to the callback.
+   The rows of a side come in order from 0, the bitset grows with them; BIODIFF_ERROR
+   when it can not, the result kept as it was */
+static int Mark_row(Biodiff *bd, Biodiff_result *result, int side, long row, int matched, char *line)
+{
+    unsigned char *bits;
+    if (!(row & 32767))
+    {
+        if (!(bits = (unsigned char *) Retake(result -> stat, BIODIFF_MEM_ARRAYS, result -> matched[side], row >> 3, (row >> 3) + 4096)))
+            return Fail(bd, "Can not take the bitset of %ld rows.", row + 1);
+        result -> matched[side] = bits;
+        memset(bits + (row >> 3), 0, 4096);
+    }
+    if (matched)
+        MARK(result -> matched[side], row);
+    result -> rows[side] = row + 1;
+    if (result -> emit)
+        result -> emit(result -> arg, side, row, matched, line);
+    return BIODIFF_OK;
+}
+
+/******************************************************************************/
+/* In_shard: whether a key belongs to the shard of the context. Equal keys are split by the
+   high bits of their hash, the low ones choose the partitions; prefix keys by their first
+   byte like the partitions, and an empty key, a prefix of every key, is in every shard */
+static int In_shard(Biodiff *bd, int mode, char *key)
+{
+    if (mode == BIODIFF_PREFIX)
+        return !*key || (unsigned char) *key % bd -> opt.shards == bd -> opt.shard;
+    return (Hash_key(key) >> 32) % bd -> opt.shards == bd -> opt.shard;
+}
+
+/* Check_shard: whether the shard of the context can be compared in a mode, BIODIFF_OK when
+   the context is not split. Keys within some edits of each other may be in any shard, and
+   string coordinates are compared in an order that depends on the marks set before */
+static int Check_shard(Biodiff *bd, int mode)
+{
+    if (bd -> opt.shards <= 1)
+        return BIODIFF_OK;
+    if (bd -> opt.shard < 0 || bd -> opt.shard >= bd -> opt.shards)
+        return Fail(bd, "Shard %d is not one of the %d shards.", bd -> opt.shard, bd -> opt.shards);
+    if (mode == BIODIFF_APPROX)
+        return Fail(bd, "[-na] can not be split into shards.");
+    if (mode == BIODIFF_OVERLAP && (bd -> opt.coord == BIODIFF_COORD_STRING || !bd -> opt.cuts))
+        return Fail(bd, "[-co] is split into shards by the cuts of integer coordinates only.");
+    if (mode == BIODIFF_OVERLAP && bd -> opt.cover)
+        return Fail(bd, "The base pairs of [-co] are not counted in shards, an interval may reach into two.");
+    return BIODIFF_OK;
+}
+
+/******************************************************************************/
+/* Biodiff_shard_cuts: the cuts that split the left end points of the intervals of n tables
+   into shards of about as many rows. A sample of them is kept as every row is read, each
+   end point kept as likely as any other, and the cuts are its quantiles. Sweep takes the
+   intervals in the order of their strings, which the shards keep to only when it is the
+   order of their numbers; that is told by Digit_order as the rows are read, up to the first
+   row that breaks it */
+int Biodiff_shard_cuts(Biodiff *bd, Biodiff_table **table, int n, int shards, int *cuts)
+{
+    struct Cursor cursor;
+    char start[COLUMN_SIZE];
+    uint64_t x = 88172645463325252ULL;   /* xorshift, the same sample for the same tables */
+    int64_t most[11], least[11];
+    long seen = 0, m = 0, k;
+    int *sample, t, i, split = 1;
+    if (bd -> opt.coord == BIODIFF_COORD_STRING)
+        return Fail(bd, "[-co] is split into shards by the cuts of integer coordinates only.");
+    if (shards < 2)
+        return BIODIFF_OK;
+    sample = (int *) Take(&bd -> stat, BIODIFF_MEM_ARRAYS, sizeof(int) * SHARD_SAMPLE);
+    for (t = 0; t < n && split; t++)
+    {
+        if (Open_rows(bd, table[t], &cursor))
+            break;
+        for (i = 0; i < 11; i++)
+        {
+            most[i] = -1;
+            least[i] = INT64_MAX;
+        }
+        for (; split && Next_row(&cursor); seen++)
+        {
+            *start = 0;
+            Get_col(cursor.line, start, SEPARATORS, table[t] -> col[0]);
+            split = Digit_order(start, most, least);   /* the pass is left open at the first row out of order */
+            if (m < SHARD_SAMPLE)
+                sample[m++] = atoi(start);
+            else
+            {
+                x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+                if ((k = x % (seen + 1)) < SHARD_SAMPLE)
+                    sample[k] = atoi(start);
+            }
+        }
+        if (split && Close_rows(bd, &cursor))
+            break;
+    }
+    if (t == n && split)
+    {
+        qsort(sample, m, sizeof(int), Cmp_int);
+        for (i = 1; i < shards; i++)
+            cuts[i - 1] = m ? sample[m * i / shards] : 0;
+    }
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, sample, sizeof(int) * SHARD_SAMPLE);
+    return !split ? BIODIFF_UNSPLIT : t < n ? BIODIFF_ERROR : BIODIFF_OK;
+}
+
+/******************************************************************************/
+/* Biodiff_result_free: release the bitsets of a result */
+void Biodiff_result_free(Biodiff_result *result)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        Give(result -> stat, BIODIFF_MEM_ARRAYS, result -> matched[i], MARK_BYTES(result -> rows[i]));
+        result -> matched[i] = NULL;
+        result -> rows[i] = 0;
+    }
+}
+
+/******************************************************************************/
+/* Biodiff_compare: find the rows of A and B with a match in the other.
+   The result is filled anew, its callback is kept. */
+int Biodiff_compare(Biodiff *bd, int mode, Biodiff_table *A, Biodiff_table *B, Biodiff_result *result)
+{
+    int status;
+    Biodiff_result_free(result);
+    result -> stat = &bd -> stat;
+    if (Check_shard(bd, mode) || (mode != BIODIFF_OVERLAP && Check_keys(bd, (Biodiff_table *[]) {A, B}, 2)))
+        return BIODIFF_ERROR;
+    Perf_phase(bd, BIODIFF_PHASE_READ);
+    if (mode == BIODIFF_OVERLAP)
+        status = c_overlap(bd, A, B, result);
+    else if (mode == BIODIFF_APPROX)
+        status = a_diff(bd, A, B, result);
+    else if (mode != BIODIFF_EQUAL && mode != BIODIFF_PREFIX)
+        status = Fail(bd, "Unknown mode %d.", mode);
+    else if (bd -> opt.engine == ENGINE_PARTITION)
+        status = p_diff(bd, A, B, result, mode);
+    else
+        status = k_diff(bd, A, B, result, mode);
+    Perf_phase(bd, -1);   /* the time between the calls is not charged */
+    return status;
+}
+
+/******************************************************************************/
+/* Table_index: the index of a table for a mode, built on the first call */
+static Index *Table_index(Biodiff *bd, Biodiff_table *table, int mode)
+{
+    struct Cursor cursor;
+    struct Batch *batch;
+    Index *index;
+    int i, phase = bd -> phase;
+    if (table -> index[mode])
+        return table -> index[mode];
+    if (Open_rows(bd, table, &cursor))
+        return NULL;
+    cursor.shard = mode;
+    index = Index_create(bd, table -> stat, bd -> opt.engine, mode);
+    batch = (struct Batch *) Take(&bd -> stat, BIODIFF_MEM_IO, sizeof(struct Batch));
+    while (Next_batch(bd, &cursor, batch))
+    {
+        Perf_phase(bd, BIODIFF_PHASE_BUILD);
+        for (i = 0; i < batch -> n; i++)
+            Index_insert(bd, index, batch -> key[i]);
+    }
+    Give(&bd -> stat, BIODIFF_MEM_IO, batch, sizeof(struct Batch));
+    Perf_phase(bd, BIODIFF_PHASE_BUILD);
+    if (Close_rows(bd, &cursor) || Index_ready(bd, index))
+    {
+        Index_free(index);
+        Perf_phase(bd, phase);
+        return NULL;
+    }
+    Perf_phase(bd, phase);
+    return table -> index[mode] = index;
+}
+
+/******************************************************************************/
+/* k_diff: key-based differences with an in-memory index, for [-ce], [-ne] and [-no].
+   The index of fileB is built while fileB is searched, unless it was built before.
+   The rows are probed in batches, see Index_probe. */
+static int k_diff(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, Biodiff_result *result, int mode)
+{
+    struct Cursor cursor;
+    struct Batch *batch;
+    Index *index_A, *index_B = B -> index[mode];
+    long row;
+    int i, failed = 0, status = BIODIFF_ERROR;
+    /* bulid an index according to fileA, or reuse it */
+    if (!(index_A = Table_index(bd, A, mode)) || Open_rows(bd, B, &cursor))
+        return BIODIFF_ERROR;
+    cursor.shard = mode;
+    if (!index_B)
+        index_B = Index_create(bd, B -> stat, bd -> opt.engine, mode);
+    batch = (struct Batch *) Take(&bd -> stat, BIODIFF_MEM_IO, sizeof(struct Batch));
+    /* search the rows of fileB */
+    for (row = 0; Next_batch(bd, &cursor, batch); )
+    {
+        Perf_phase(bd, BIODIFF_PHASE_PROBE);
+        Index_probe(bd, index_A, batch -> key, batch -> n, batch -> found);
+        Perf_phase(bd, BIODIFF_PHASE_WRITE);
+        for (i = 0; i < batch -> n && !failed; i++, row++)
+            failed = Mark_row(bd, result, 1, row, batch -> found[i], batch -> line[i]);
+        if (failed)
+            break;   /* the pass is left open, its count of rows is not the table's */
+        if (B -> index[mode])
+            continue;
+        Perf_phase(bd, BIODIFF_PHASE_BUILD);
+        for (i = 0; i < batch -> n; i++)
+            Index_insert(bd, index_B, batch -> key[i]);   /* build an index according to fileB */
+    }
+    if (failed || Close_rows(bd, &cursor))
+    {
+        if (!B -> index[mode])
+            Index_free(index_B);
+        Give(&bd -> stat, BIODIFF_MEM_IO, batch, sizeof(struct Batch));
+        return BIODIFF_ERROR;
+    }
+    if (!B -> index[mode])
+    {
+        Perf_phase(bd, BIODIFF_PHASE_BUILD);
+        if (Index_ready(bd, index_B))
+        {
+            Index_free(index_B);
+            Give(&bd -> stat, BIODIFF_MEM_IO, batch, sizeof(struct Batch));
+            return BIODIFF_ERROR;
+        }
+        B -> index[mode] = index_B;
+    }
+    /* search the rows of fileA */
+    if (!Open_rows(bd, A, &cursor))
+    {
+        cursor.shard = mode;
+        for (row = 0; !failed && Next_batch(bd, &cursor, batch); )
+        {
+            Perf_phase(bd, BIODIFF_PHASE_PROBE);
+            Index_probe(bd, index_B, batch -> key, batch -> n, batch -> found);
+            Perf_phase(bd, BIODIFF_PHASE_WRITE);
+            for (i = 0; i < batch -> n && !failed; i++, row++)
+                failed = Mark_row(bd, result, 0, row, batch -> found[i], batch -> line[i]);
+        }
+        status = failed ? BIODIFF_ERROR : Close_rows(bd, &cursor);
+    }
+    Give(&bd -> stat, BIODIFF_MEM_IO, batch, sizeof(struct Batch));
+    return status;
+}
+
+/******************************************************************************/
+/* a_diff: name-based differences within opt.distance edits, for [-na].
+   Both tables get the radix tree of [-no], reused when it was built before,
+   and every key of each table searches the tree of the other, see Search_approx. */
+static int a_diff(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, Biodiff_result *result)
+{
+    struct Approx approx = {NULL, NULL, 0, 0, NULL, 0, 0, NULL};
+    struct Cursor cursor;
+    struct Batch *batch;
+    Biodiff_table *table[2] = {A, B};
+    Index *index[2];
+    long row;
+    int side, i, status = BIODIFF_OK;
+    if (bd -> opt.distance < 0)
+        return Fail(bd, "The distance %d is negative.", bd -> opt.distance);
+    if (!(index[0] = Table_index(bd, A, BIODIFF_PREFIX)) || !(index[1] = Table_index(bd, B, BIODIFF_PREFIX)))
+        return BIODIFF_ERROR;
+    approx.k = bd -> opt.distance;
+    approx.stat = &bd -> stat;
+    batch = (struct Batch *) Take(&bd -> stat, BIODIFF_MEM_IO, sizeof(struct Batch));
+    for (side = 0; !status && side < 2; side++)
+    {
+        approx.tree = index[!side] -> radix;
+        if (!(status = Open_rows(bd, table[side], &cursor)))
+        {
+            for (row = 0; !status && Next_batch(bd, &cursor, batch); )
+            {
+                Perf_phase(bd, BIODIFF_PHASE_PROBE);
+                for (i = 0; i < batch -> n; i++)
+                    batch -> found[i] = Search_approx(&approx, batch -> key[i]);
+                Perf_phase(bd, BIODIFF_PHASE_WRITE);
+                for (i = 0; i < batch -> n && !status; i++, row++)
+                    status = Mark_row(bd, result, side, row, batch -> found[i], batch -> line[i]);
+            }
+            bd -> stat.approx_probes += row;
+            if (!status)
+                status = Close_rows(bd, &cursor);
+        }
+    }
+    bd -> stat.approx_nodes += approx.nodes;
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, approx.rows, sizeof(int) * approx.size);
+    Give(&bd -> stat, BIODIFF_MEM_IO, batch, sizeof(struct Batch));
+    return status;
+}
+
+/******************************************************************************/
+/* Split_file: write the row number and the key of every line to its partition,
+   and return the number of rows, -1 on error. Prefix keys are split on their first
+   character, so that a key and all keys it is a prefix of meet in one partition.
+   Only the keys of the shard of the context are written, the others are counted. */
+static long Split_file(Biodiff *bd, Biodiff_table *table, FILE **part, int parts, int mode)
+{
+    struct Cursor cursor;
+    char column[KEY_SIZE], *key;
+    int row = 0;
+    unsigned short len;
+    FILE *temp;
+    if (Open_rows(bd, table, &cursor))
+        return -1;
+    while (Next_row(&cursor))
+    {
+        key = Row_key(&cursor, column);
+        if (bd -> opt.shards > 1 && !In_shard(bd, mode, key))
+        {
+            row++;
+            continue;
+        }
+        len = strlen(key);
+        temp = part[mode == 1 ? Hash_key(key) % parts : (unsigned char) *key % parts];
+        fwrite(&row, sizeof(int), 1, temp);
+        fwrite(&len, sizeof(len), 1, temp);
+        fwrite(key, 1, len, temp);
+        row++;
+    }
+    return Close_rows(bd, &cursor) ? -1 : row;
+}
+
+/* Read_part: read the next row number and key from a partition */
+static int Read_part(FILE *part, int *row, char *key)
+{
+    unsigned short len;
+    if (fread(row, sizeof(int), 1, part) != 1 || fread(&len, sizeof(len), 1, part) != 1)
+        return 0;
+    if (fread(key, 1, len, part) != len)
+        return 0;
+    key[len] = 0;
+    return 1;
+}
+
+/* Mark_part: mark the rows of one partition whose keys are found in the other's index */
+static void Mark_part(Biodiff *bd, FILE *build, FILE *probe, unsigned char *mark, int mode)
+{
+    struct Batch *batch = (struct Batch *) Take(&bd -> stat, BIODIFF_MEM_IO, sizeof(struct Batch));
+    int row[PROBE_BATCH], i;
+    Index *index = Index_create(bd, &bd -> stat, ENGINE_HASH, mode);
+    Perf_phase(bd, BIODIFF_PHASE_BUILD);
+    rewind(build);
+    while (Read_part(build, row, batch -> column[0]))
+        Index_insert(bd, index, batch -> column[0]);
+    Index_ready(bd, index);
+    Perf_phase(bd, BIODIFF_PHASE_PROBE);
+    rewind(probe);
+    do
+    {
+        for (batch -> n = 0; batch -> n < Batch_size(bd) && Read_part(probe, row + batch -> n, batch -> column[batch -> n]); batch -> n++)
+            batch -> key[batch -> n] = batch -> column[batch -> n];
+        Index_probe(bd, index, batch -> key, batch -> n, batch -> found);
+        for (i = 0; i < batch -> n; i++)
+            if (batch -> found[i])
+                MARK(mark, row[i]);
+    }
+    while (batch -> n);
+    Index_free(index);
+    Give(&bd -> stat, BIODIFF_MEM_IO, batch, sizeof(struct Batch));
+}
+
+/* Mark_rows: pass every row of a table to the result according to its mark */
+static int Mark_rows(Biodiff *bd, Biodiff_table *table, int side, const unsigned char *mark, Biodiff_result *result)
+{
+    struct Cursor cursor;
+    long row;
+    if (Open_rows(bd, table, &cursor))
+        return BIODIFF_ERROR;
+    for (row = 0; Next_row(&cursor); row++)
+        if (Mark_row(bd, result, side, row, MARKED(mark, row), cursor.line))
+            return BIODIFF_ERROR;
+    return Close_rows(bd, &cursor);
+}
+
+/* Biodiff_pass: pass every row of a table to a result as a bitset says, e.g. the
+   results of the shards of a comparison OR'ed together */
+int Biodiff_pass(Biodiff *bd, Biodiff_table *table, int side, const unsigned char *matched, Biodiff_result *result)
+{
+    int status;
+    if (!result -> matched[0] && !result -> matched[1])
+        result -> stat = &bd -> stat;
+    Perf_phase(bd, BIODIFF_PHASE_WRITE);
+    status = Mark_rows(bd, table, side, matched, result);
+    Perf_phase(bd, -1);
+    return status;
+}
+
+/******************************************************************************/
+/* p_diff: key-based differences with the keys split into partitions on disk */
+static int p_diff(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, Biodiff_result *result, int mode)
+{
+    int parts = bd -> opt.partitions ? bd -> opt.partitions : 16, i, status = BIODIFF_ERROR;
+    long row_A, row_B;
+    FILE **part_A = (FILE **) Take_zero(&bd -> stat, BIODIFF_MEM_IO, parts, sizeof(FILE *));
+    FILE **part_B = (FILE **) Take_zero(&bd -> stat, BIODIFF_MEM_IO, parts, sizeof(FILE *));
+    unsigned char *mark_A, *mark_B;
+    for (i = 0; i < parts; ++i)
+        if (!(part_A[i] = tmpfile()) || !(part_B[i] = tmpfile()))
+            break;
+    if (i < parts)
+        Fail(bd, "Can not create the temporary files.");
+    else if ((row_A = Split_file(bd, A, part_A, parts, mode)) >= 0 &&
+             (row_B = Split_file(bd, B, part_B, parts, mode)) >= 0)
+    {
+        mark_A = (unsigned char *) Take_zero(&bd -> stat, BIODIFF_MEM_ARRAYS, row_A / 8 + 1, 1);  /* one bit per row */
+        mark_B = (unsigned char *) Take_zero(&bd -> stat, BIODIFF_MEM_ARRAYS, row_B / 8 + 1, 1);
+        for (i = 0; i < parts; ++i)   /* only one partition is in memory at a time */
+        {
+            Mark_part(bd, part_A[i], part_B[i], mark_B, mode);
+            Mark_part(bd, part_B[i], part_A[i], mark_A, mode);
+        }
+        Perf_phase(bd, BIODIFF_PHASE_WRITE);
+        if (!Mark_rows(bd, A, 0, mark_A, result) && !Mark_rows(bd, B, 1, mark_B, result))
+            status = BIODIFF_OK;
+        Give(&bd -> stat, BIODIFF_MEM_ARRAYS, mark_A, row_A / 8 + 1);
+        Give(&bd -> stat, BIODIFF_MEM_ARRAYS, mark_B, row_B / 8 + 1);
+    }
+    for (i = 0; i < parts; ++i)
+    {
+        if (part_A[i])
+            fclose(part_A[i]);
+        if (part_B[i])
+            fclose(part_B[i]);
+    }
+    Give(&bd -> stat, BIODIFF_MEM_IO, part_A, sizeof(FILE *) * parts);
+    Give(&bd -> stat, BIODIFF_MEM_IO, part_B, sizeof(FILE *) * parts);
+    return status;
+}
+
+/******************************************************************************/
+/* Sweep_run: mark every interval of X whose run of Y, from the first left end point not left of
+   X's own up to X's right end point, is not empty, and mark that run. The marks are set by
+   sorted position, a run at a time: the runs start in order, so only what goes past the
+   end of the runs before is marked. Like the loops over strings, the last Y is left out.
+   It is inlined with a constant kernel of Run_end, so each kernel is called directly */
+SPECIALIZE void Sweep_run(long (*run_end)(const int *start, long from, long to, int x), const int *left_X, const int *right_X,
+                          long row_X, const int *left_Y, long row_Y, unsigned char *run_X, unsigned char *run_Y)
+{
+    long i, j = 1, stop, upto = 1;
+    for (i = 1; i <= row_X; ++i)
+    {
+        if (left_X[i] > INT_MIN)      /* skip the Y whose left end point is smaller */
+            j = run_end(left_Y, j, row_Y + 1, left_X[i] - 1);
+        if (j > row_Y)
+            break;
+        if ((stop = run_end(left_Y, j, row_Y, right_X[i])) == j)
+            continue;
+        MARK(run_X, i);
+        if (stop > upto)
+        {
+            Mark_range(run_Y, j > upto ? j : upto, stop);
+            upto = stop;
+        }
+    }
+}
+
+/* Sweep: Sweep_run with the kernel of Run_end the context chose, chosen once a sweep */
+static void Sweep(Biodiff *bd, const int *left_X, const int *right_X, long row_X,
+                  const int *left_Y, long row_Y, unsigned char *run_X, unsigned char *run_Y)
+{
+#ifdef BIODIFF_X86
+    if (bd -> run_end == Run_end_avx512)
+        Sweep_run(Run_end_avx512, left_X, right_X, row_X, left_Y, row_Y, run_X, run_Y);
+    else if (bd -> run_end == Run_end_avx2)
+        Sweep_run(Run_end_avx2, left_X, right_X, row_X, left_Y, row_Y, run_X, run_Y);
+    else
+#endif
+        Sweep_run(Run_end, left_X, right_X, row_X, left_Y, row_Y, run_X, run_Y);
+}
+
+/******************************************************************************/
+/* c_overlap: coordinated-based overlap differences.
+   Integer coordinates are swept by Sweep over the ends kept apart in sorted order,
+   string coordinates are compared one by one. A side of single positions against
+   intervals is left unsorted and searched by c_point instead. */
+static int c_overlap(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, Biodiff_result *result)
+{
+    struct Interval *interval_A, *interval_B;
+    unsigned char *mark_A, *mark_B, *run_A, *run_B;
+    int status, side = -1;
+    long row_A, row_B, n_A, n_B, i, j, temp;
+    if (bd -> opt.cover && bd -> opt.coord == BIODIFF_COORD_STRING)
+        return Fail(bd, "The base pairs of [-co] are counted for integer coordinates only.");
+    if (bd -> opt.coord == BIODIFF_COORD_INT && bd -> opt.shards <= 1 && !bd -> opt.cover)
+        side = Point_table(bd, A) ? 0 : Point_table(bd, B) ? 1 : -1;
+    if (side >= 0 && (status = c_point(bd, A, B, side, result)) != POINT_NOT)
+        return status;
+    /* get and store the intervals of both files sorted by the left end point, or reuse them */
+    if (!(interval_A = Table_intervals(bd, A)) || !(interval_B = Table_intervals(bd, B)))
+        return BIODIFF_ERROR;
+    row_A = A -> rows;
+    row_B = B -> rows;
+    n_A = A -> intervals;   /* fewer in a shard */
+    n_B = B -> intervals;
+    mark_A = (unsigned char *) Take_zero(&bd -> stat, BIODIFF_MEM_ARRAYS, row_A / 8 + 1, 1);   /* one bit per row, from 1 */
+    mark_B = (unsigned char *) Take_zero(&bd -> stat, BIODIFF_MEM_ARRAYS, row_B / 8 + 1, 1);
+
+    Perf_phase(bd, BIODIFF_PHASE_SWEEP);
+    if (bd -> opt.coord == BIODIFF_COORD_INT)
+    {
+        run_A = (unsigned char *) Take_zero(&bd -> stat, BIODIFF_MEM_ARRAYS, n_A / 8 + 1, 1);   /* one bit per sorted position */
+        run_B = (unsigned char *) Take_zero(&bd -> stat, BIODIFF_MEM_ARRAYS, n_B / 8 + 1, 1);
+        Sweep(bd, A -> left, A -> right, n_A, B -> left, n_B, run_A, run_B);
+        Sweep(bd, B -> left, B -> right, n_B, A -> left, n_A, run_B, run_A);
+        for (i = 1; i <= n_A; ++i)
+            if (MARKED(run_A, i))
+                MARK(mark_A, interval_A[i].row);
+        for (i = 1; i <= n_B; ++i)
+            if (MARKED(run_B, i))
+                MARK(mark_B, interval_B[i].row);
+        Give(&bd -> stat, BIODIFF_MEM_ARRAYS, run_A, n_A / 8 + 1);
+        Give(&bd -> stat, BIODIFF_MEM_ARRAYS, run_B, n_B / 8 + 1);
+        if (bd -> opt.cover)
+            Cover_spans(bd, A, B);
+    }
+    else
+    {
+        /* judge whether the coordinate is overlap and mark it. */
+        for(i=1, j=1; i <= n_A; ++i) /* mark when B's left end point is between A's left & right end point.*/
+        {
+            for(; j <= n_B; ++j)
+            {
+                /* skip extra B when B's left end point is smaller than A' left end point */
+                if (Cmp_coord(BIODIFF_COORD_STRING, interval_A + i, 0, interval_B + j) > 0) continue;
+                else
+                    for(temp = j; temp<n_B; ++temp) /* search for target B and mark both A and B */
+                    {
+                        /* break when B's left end point is biger than A's right point */
+                        if(Cmp_coord(BIODIFF_COORD_STRING, interval_A + i, 1, interval_B + temp) < 0)
+                            break;
+                        else if(MARKED(mark_B, interval_B[temp].row)) continue; /* skip the B which has already been marked */
+                        else
+                            MARK(mark_A, interval_A[i].row), MARK(mark_B, interval_B[temp].row); /* mark on both A&B*/
+                    }
+                break;
+            }
+        }
+        for(i=1, j=1; j <= n_B; ++j)/* mark when A's left end point is between B's left & right end point.*/
+        {
+            for(; i <= n_A; ++i)
+            {
+                /* skip extra A when A's left end point is smaller than B' left end point */
+                if (Cmp_coord(BIODIFF_COORD_STRING, interval_B + j, 0, interval_A + i) > 0) continue;
+                else
+                    for(temp = i; temp<n_A; ++temp) /* search for target B and mark both A and B */
+                    {
+                        /* break when A's left end point is biger than B's right point */
+                        if(Cmp_coord(BIODIFF_COORD_STRING, interval_B + j, 1, interval_A + temp) < 0)
+                            break;
+                        else if(MARKED(mark_A, interval_A[temp].row)) continue;  /* skip the B which has already been marked */
+                        else
+                            MARK(mark_A, interval_A[temp].row), MARK(mark_B, interval_B[j].row); /* mark on both A&B*/
+                    }
+                break;
+            }
+        }
+    }
+    return Pass_marks(bd, A, B, mark_A, mark_B, result);
+}
+
+/* Merge_spans: merge the overlapping intervals of a table into spans, in one pass over their
+   ends in sorted order; the empty ones, right end before left end, are left out. When their
+   strings are not in the order of their numbers, as with numbers of other lengths, the ends
+   are sorted again as numbers first. The number of spans */
+static long Merge_spans(Biodiff *bd, const int *left, const int *right, long n, struct Span *span)
+{
+    long i, k, m = 0;
+    int sorted = 1;
+    for (i = 1; i <= n; i++)
+        if (right[i] >= left[i])
+        {
+            sorted &= !m || left[i] >= span[m - 1].left;
+            span[m].left = left[i];
+            span[m++].right = right[i];
+        }
+    if (!sorted)
+    {
+        Perf_phase(bd, BIODIFF_PHASE_SORT);
+        qsort(span, m, sizeof(struct Span), Cmp_span);
+        bd -> stat.cover_sorted++;
+        Perf_phase(bd, BIODIFF_PHASE_SWEEP);
+    }
+    for (i = k = 0; i < m; i++)
+        if (k && span[i].left <= span[k - 1].right)   /* overlapping the last span, or nested in it */
+            span[k - 1].right = span[i].right > span[k - 1].right ? span[i].right : span[k - 1].right;
+        else
+            span[k++] = span[i];
+    return k;
+}
+
+/* Cover_spans: count the base pairs covered by each table from its spans, and those of both
+   by walking the spans of both tables together */
+static void Cover_spans(Biodiff *bd, Biodiff_table *A, Biodiff_table *B)
+{
+    struct Span *span_A, *span_B;
+    long n_A, n_B, i, j;
+    int64_t left, right;
+    span_A = (struct Span *) Take(&bd -> stat, BIODIFF_MEM_ARRAYS, sizeof(struct Span) * (A -> intervals + 1));
+    span_B = (struct Span *) Take(&bd -> stat, BIODIFF_MEM_ARRAYS, sizeof(struct Span) * (B -> intervals + 1));
+    n_A = Merge_spans(bd, A -> left, A -> right, A -> intervals, span_A);
+    n_B = Merge_spans(bd, B -> left, B -> right, B -> intervals, span_B);
+    for (i = 0; i < n_A; i++)
+        bd -> stat.cover_A += span_A[i].right - span_A[i].left + 1;
+    for (j = 0; j < n_B; j++)
+        bd -> stat.cover_B += span_B[j].right - span_B[j].left + 1;
+    for (i = j = 0; i < n_A && j < n_B; )
+    {
+        left = span_A[i].left > span_B[j].left ? span_A[i].left : span_B[j].left;
+        right = span_A[i].right < span_B[j].right ? span_A[i].right : span_B[j].right;
+        if (right >= left)
+            bd -> stat.cover_both += right - left + 1;
+        if (span_A[i].right < span_B[j].right)   /* the span ending first meets no more of the other */
+            i++;
+        else
+            j++;
+    }
+    bd -> stat.cover_spans_A += n_A;
+    bd -> stat.cover_spans_B += n_B;
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, span_A, sizeof(struct Span) * (A -> intervals + 1));
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, span_B, sizeof(struct Span) * (B -> intervals + 1));
+}
+
+/* Pass_marks: pass every row to the result according to its mark, and release the marks */
+static int Pass_marks(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, unsigned char *mark_A, unsigned char *mark_B, Biodiff_result *result)
+{
+    struct Cursor cursor;
+    long row_A = A -> rows, row_B = B -> rows, i;
+    int status;
+    Perf_phase(bd, BIODIFF_PHASE_WRITE);
+    if (!(status = Open_rows(bd, A, &cursor)))
+    {
+        for (i = 1; !status && i <= row_A && Next_row(&cursor); ++i)
+            status = Mark_row(bd, result, 0, i - 1, MARKED(mark_A, i), cursor.line);
+        if (!status)
+            status = Close_rows(bd, &cursor);
+    }
+    if (!status && !(status = Open_rows(bd, B, &cursor)))
+    {
+        for (i = 1; !status && i <= row_B && Next_row(&cursor); ++i)
+            status = Mark_row(bd, result, 1, i - 1, MARKED(mark_B, i), cursor.line);
+        if (!status)
+            status = Close_rows(bd, &cursor);
+    }
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, mark_A, row_A / 8 + 1);
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, mark_B, row_B / 8 + 1);
+    return status;
+}
+
+/******************************************************************************/
+/* Point_table: whether the first rows of a table are single positions, start equal to end,
+   so that c_point may leave it unsorted; not when its intervals are kept already */
+static int Point_table(Biodiff *bd, Biodiff_table *table)
+{
+    struct Cursor cursor;
+    char start[COLUMN_SIZE], end[COLUMN_SIZE];
+    int n = 0;
+    if (table -> interval || Open_rows(bd, table, &cursor))
+        return 0;
+    while (n < SAMPLE_ROWS && Next_row(&cursor))
+    {
+        *start = *end = 0;
+        Get_col(cursor.line, start, SEPARATORS, table -> col[0]);
+        Get_col(cursor.line, end, SEPARATORS, table -> col[1]);
+        if (atoi(start) != atoi(end))
+            return 0;
+        n++;
+    }
+    return n > 0;   /* the pass is left open: its count of rows is not the table's */
+}
+
+/* Digit_order: add a position to most, the largest of each number of digits, and to least, the
+   smallest first p digits of the longer ones. Positions of plain digits sort as strings the way
+   they sort as numbers unless a shorter one is above the first digits of a longer one, that is
+   most[p] > least[p] for some p; only the p the position changes are looked at, so that the
+   position that breaks the order is 0 already. 0 too for a sign, a leading zero, more than
+   10 digits or anything else */
+static int Digit_order(const char *s, int64_t *most, int64_t *least)
+{
+    int64_t v = 0;
+    int p;
+    if (*s == '0' && s[1])
+        return 0;
+    for (p = 0; s[p]; p++)
+    {
+        if (s[p] < '0' || s[p] > '9' || p == 10)
+            return 0;
+        if (p && v < least[p] && most[p] > (least[p] = v))
+            return 0;   /* a shorter one above its first digits: "10" before "9" */
+        v = v * 10 + s[p] - '0';
+    }
+    if (p && v > most[p] && (most[p] = v) > least[p])
+        return 0;
+    return p > 0;
+}
+
+/* Eytzinger: lay out the sorted bounds in Eytzinger order, in order from node k down; the
+   tree is full, the nodes past the last bound are larger than any. The next bound to lay out */
+static long Eytzinger(const int64_t *sorted, long m, int64_t *key, int *rank, long size, long i, long k)
+{
+    if (k >= size)
+        return i;
+    i = Eytzinger(sorted, m, key, rank, size, i, 2 * k);
+    key[k] = i < m ? sorted[i] : INT64_MAX;
+    rank[k] = i < m ? i : m;
+    return Eytzinger(sorted, m, key, rank, size, i + 1, 2 * k + 1);
+}
+
+/* c_point: [-co] of a side of single positions against the intervals of the other side, for
+   many positions and few intervals. Only the intervals are sorted: their left ends and the
+   coordinates after their right ends cut the line into segments, whose bounds are laid out in
+   Eytzinger order so that a search reads the first levels from cache. The positions are read in
+   the order of their file and searched a batch at a time, every step of a search free of branches
+   and the steps of the batch overlapping their misses. The marks are those of Sweep: a position
+   and an interval match when the position is within it, but for the last position, or when the
+   interval starts there, but for the last interval, the last in the order of Cmp_interval.
+   Sweep takes both sides in the order of their strings, so the marks agree only when that is
+   the order of their numbers, as it is for coordinates of as many digits; positions of 1 to 9
+   digits as they come are not, and Sweep takes them from the first one that tells so.
+   POINT_NOT when a row is not a single position after all, or the orders differ, with nothing
+   passed to the result */
+static int c_point(Biodiff *bd, Biodiff_table *A, Biodiff_table *B, int side, Biodiff_result *result)
+{
+    Biodiff_table *P = side ? B : A, *R = side ? A : B;
+    struct Interval *interval;
+    struct Cursor cursor;
+    char start[COLUMN_SIZE], end[COLUMN_SIZE], last_start[COLUMN_SIZE] = "", last_end[COLUMN_SIZE] = "";
+    int64_t *bound, *key, x[POINT_BATCH], last_x = 0, most[11], least[11];
+    int *rank, *cover, *lo, *hi, status = BIODIFF_OK, levels;
+    unsigned char *hit, *exact, *is_left, *mark_P, *mark_R = NULL;
+    long n, m, i, j, b, size, marks = 4096, row = 0, last = 0, last_seg = -1, k[POINT_BATCH], seg;
+
+    /* the segments of the intervals, and how many intervals cover each */
+    if (!(interval = Table_intervals(bd, R)))
+        return BIODIFF_ERROR;
+    for (i = 2; i <= R -> intervals; i++)
+        if (R -> left[i] < R -> left[i - 1])
+            return POINT_NOT;   /* the strings of the intervals are not in the order of their numbers */
+    for (i = 0; i < 11; i++)
+    {
+        most[i] = -1;
+        least[i] = INT64_MAX;
+    }
+    Perf_phase(bd, BIODIFF_PHASE_BUILD);
+    n = R -> intervals;
+    bound = (int64_t *) Take(&bd -> stat, BIODIFF_MEM_INDEX, sizeof(int64_t) * (2 * n + 1));
+    for (i = 1, m = 0; i <= n; i++)
+    {
+        bound[m++] = interval[i].left;
+        if (interval[i].right >= interval[i].left)
+            bound[m++] = (int64_t) interval[i].right + 1;
+    }
+    qsort(bound, m, sizeof(int64_t), Cmp_int64);
+    for (i = j = 0; i < m; i++)   /* each bound once */
+        if (!j || bound[i] != bound[j - 1])
+            bound[j++] = bound[i];
+    m = j;
+    for (levels = 1, size = 2; size - 1 < m; levels++)
+        size *= 2;
+    key = (int64_t *) Take_pages(bd, &bd -> stat, BIODIFF_MEM_INDEX, sizeof(int64_t) * size);
+    rank = (int *) Take_pages(bd, &bd -> stat, BIODIFF_MEM_INDEX, sizeof(int) * size);
+    Eytzinger(bound, m, key, rank, size, 0, 1);
+    cover = (int *) Take_zero(&bd -> stat, BIODIFF_MEM_INDEX, m + 1, sizeof(int));
+    hit = (unsigned char *) Take_zero(&bd -> stat, BIODIFF_MEM_INDEX, m + 1, 3);   /* hit, exact and is_left by segment */
+    exact = hit + m + 1;
+    is_left = exact + m + 1;
+    lo = (int *) Take(&bd -> stat, BIODIFF_MEM_ARRAYS, sizeof(int) * (n + 1));
+    hi = (int *) Take(&bd -> stat, BIODIFF_MEM_ARRAYS, sizeof(int) * (n + 1));
+    for (i = 1; i <= n; i++)
+    {
+        lo[i] = (int64_t *) bsearch(&(int64_t) {interval[i].left}, bound, m, sizeof(int64_t), Cmp_int64) - bound;
+        hi[i] = interval[i].right < interval[i].left ? lo[i] :
+                (int64_t *) bsearch(&(int64_t) {(int64_t) interval[i].right + 1}, bound, m, sizeof(int64_t), Cmp_int64) - bound;
+        cover[lo[i]]++;
+        cover[hi[i]]--;
+        if (i < n)
+            is_left[lo[i]] = 1;   /* an interval starts here, not the last one */
+    }
+    for (i = 1; i <= m; i++)
+        cover[i] += cover[i - 1];
+
+    /* search the positions as they come, and mark them by row */
+    mark_P = (unsigned char *) Take_zero(&bd -> stat, BIODIFF_MEM_ARRAYS, marks, 1);
+    if (Open_rows(bd, P, &cursor))
+        status = BIODIFF_ERROR;
+    while (status == BIODIFF_OK)
+    {
+        Perf_phase(bd, BIODIFF_PHASE_READ);
+        for (b = 0; b < POINT_BATCH && Next_row(&cursor); b++)
+        {
+            *start = *end = 0;
+            Get_col(cursor.line, start, SEPARATORS, P -> col[0]);
+            Get_col(cursor.line, end, SEPARATORS, P -> col[1]);
+            x[b] = atoi(start);
+            if (strcmp(start, end) || !Digit_order(start, most, least))
+            {
+                status = POINT_NOT;   /* the pass is left open, Sweep reads the table again */
+                break;
+            }
+            if (strcmp(start, last_start) > 0 || (!strcmp(start, last_start) && strcmp(end, last_end) >= 0) || !last)
+            {
+                strcpy(last_start, start);
+                strcpy(last_end, end);
+                last = row + b + 1;
+                last_x = x[b];
+            }
+        }
+        if (!b || status)
+            break;
+        Perf_phase(bd, BIODIFF_PHASE_PROBE);
+        for (i = 0; i < b; i++)
+            k[i] = 1;
+        for (j = 0; j < levels; j++)
+            for (i = 0; i < b; i++)
+            {
+                k[i] = 2 * k[i] + (key[k[i]] <= x[i]);
+                if (j + 1 < levels)
+                    PREFETCH(key + k[i]);
+            }
+        if ((row + b) / 8 + 1 > marks)
+        {
+            mark_P = (unsigned char *) Retake(&bd -> stat, BIODIFF_MEM_ARRAYS, mark_P, marks, marks * 2);
+            memset(mark_P + marks, 0, marks);
+            marks *= 2;
+        }
+        for (i = 0; i < b; i++)
+        {
+            k[i] >>= __builtin_ffsl(~k[i]);   /* the node of the first bound past the position */
+            seg = (k[i] ? rank[k[i]] : m) - 1;
+            if (row + i + 1 == last)
+                last_seg = seg;
+            if (seg < 0)
+                continue;
+            if (cover[seg] && hit[seg] < 2)
+                hit[seg]++;   /* at least two, the last position may be taken away */
+            if (bound[seg] == x[i])
+                exact[seg] = 1;
+            if (cover[seg] || (bound[seg] == x[i] && is_left[seg]))
+                MARK(mark_P, row + i + 1);
+        }
+        row += b;
+    }
+    if (status == BIODIFF_OK && !(status = Close_rows(bd, &cursor)) && last_seg >= 0)
+    {
+        seg = last_seg;   /* the last position is within no interval for Sweep, only at the start of one */
+        if (cover[seg])
+            hit[seg]--;
+        if (bound[seg] != last_x || !is_left[seg])
+            mark_P[last >> 3] &= ~(1 << (last & 7));
+    }
+    if (status == BIODIFF_OK)
+    {
+        bd -> stat.point_rows += row;
+        bd -> stat.point_bounds += m;
+        /* an interval holding a position, or starting at one */
+        mark_R = (unsigned char *) Take_zero(&bd -> stat, BIODIFF_MEM_ARRAYS, R -> rows / 8 + 1, 1);
+        for (i = 1; i <= m; i++)
+            cover[i - 1] = (i > 1 ? cover[i - 2] : 0) + (hit[i - 1] > 0);   /* segments hit up to i */
+        for (i = 1; i <= n; i++)
+            if ((hi[i] > lo[i] && cover[hi[i] - 1] - (lo[i] ? cover[lo[i] - 1] : 0) > 0) || (i < n && exact[lo[i]]))
+                MARK(mark_R, interval[i].row);
+        mark_P = (unsigned char *) Retake(&bd -> stat, BIODIFF_MEM_ARRAYS, mark_P, marks, P -> rows / 8 + 1);
+    }
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, lo, sizeof(int) * (n + 1));
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, hi, sizeof(int) * (n + 1));
+    Give(&bd -> stat, BIODIFF_MEM_INDEX, hit, 3 * (m + 1));
+    Give(&bd -> stat, BIODIFF_MEM_INDEX, cover, sizeof(int) * (m + 1));
+    Give_pages(&bd -> stat, BIODIFF_MEM_INDEX, key, sizeof(int64_t) * size);
+    Give_pages(&bd -> stat, BIODIFF_MEM_INDEX, rank, sizeof(int) * size);
+    Give(&bd -> stat, BIODIFF_MEM_INDEX, bound, sizeof(int64_t) * (2 * n + 1));
+    if (status != BIODIFF_OK)
+    {
+        Give(&bd -> stat, BIODIFF_MEM_ARRAYS, mark_P, marks);
+        return status;
+    }
+    return side ? Pass_marks(bd, R, P, mark_R, mark_P, result) : Pass_marks(bd, P, R, mark_P, mark_R, result);
+}
+
+/******************************************************************************/
+/* Mark_member: record which tables hold a match of a row and pass it to the callback.
+   The rows of a table come in order from 0, their words grow with them. */
+static void Mark_member(Biodiff_venn *venn, int table, long row, uint64_t member, char *line)
+{
+    if (!(row & 4095))
+        venn -> member[table] = (uint64_t *) Retake(venn -> stat, BIODIFF_MEM_ARRAYS, venn -> member[table], sizeof(uint64_t) * row, sizeof(uint64_t) * (row + 4096));
+    venn -> member[table][row] = member;
+    venn -> rows[table] = row + 1;
+    if (venn -> emit)
+        venn -> emit(venn -> arg, table, row, member, line);
+}
+
+/******************************************************************************/
+/* Biodiff_venn_free: release the words of a result */
+void Biodiff_venn_free(Biodiff_venn *venn)
+{
+    for (int i = 0; i < BIODIFF_MAX_TABLES; i++)
+    {
+        Give(venn -> stat, BIODIFF_MEM_ARRAYS, venn -> member[i], sizeof(uint64_t) * MEMBER_WORDS(venn -> rows[i]));
+        venn -> member[i] = NULL;
+        venn -> rows[i] = 0;
+    }
+}
+
+/******************************************************************************/
+/* Biodiff_sketch_table: sketch the distinct keys of a table in one pass. Every key hash
+   raises a HyperLogLog register to the rank of its first 1-bit; the hashes under the
+   largest of the smallest BIODIFF_SKETCH_K so far are gathered, and cut back to those
+   K whenever they fill the buffer, so that most keys only cost a comparison */
+int Biodiff_sketch_table(Biodiff *bd, Biodiff_table *table, Biodiff_sketch *sketch)
+{
+    struct Cursor cursor;
+    char column[KEY_SIZE];
+    uint64_t h, w, limit = UINT64_MAX, *hash;
+    long n = 0, size = 4 * BIODIFF_SKETCH_K;
+    int rank;
+    memset(sketch, 0, sizeof(Biodiff_sketch));
+    sketch -> keys = table -> keys;
+    memcpy(sketch -> col, table -> col, sizeof(sketch -> col));
+    memcpy(sketch -> type, table -> type, sizeof(sketch -> type));
+    sketch -> fold = bd -> opt.fold;
+    if (Open_rows(bd, table, &cursor))
+        return BIODIFF_ERROR;
+    hash = (uint64_t *) Take(&bd -> stat, BIODIFF_MEM_ARRAYS, sizeof(uint64_t) * size);
+    Perf_phase(bd, BIODIFF_PHASE_READ);
+    while (Next_row(&cursor))
+    {
+        h = Hash_key(Row_key(&cursor, column));
+        w = h << BIODIFF_SKETCH_BITS;
+        rank = w ? __builtin_clzll(w) + 1 : 64 - BIODIFF_SKETCH_BITS + 1;
+        if (sketch -> reg[h >> (64 - BIODIFF_SKETCH_BITS)] < rank)
+            sketch -> reg[h >> (64 - BIODIFF_SKETCH_BITS)] = rank;
+        if (h < limit)
+        {
+            hash[n++] = h;
+            if (n == size && (n = Bottom_k(hash, n)) == BIODIFF_SKETCH_K)
+                limit = hash[n - 1];   /* a hash not under it is not kept, or is kept already */
+        }
+    }
+    n = Bottom_k(hash, n);
+    memcpy(sketch -> bottom, hash, sizeof(uint64_t) * n);
+    sketch -> k = n;
+    sketch -> rows = cursor.count;
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, hash, sizeof(uint64_t) * size);
+    Perf_phase(bd, -1);
+    return Close_rows(bd, &cursor);
+}
+
+/* Bottom_k: sort and unique the hashes of a buffer and keep the smallest BIODIFF_SKETCH_K, their number */
+static long Bottom_k(uint64_t *hash, long n)
+{
+    long i, j;
+    qsort(hash, n, sizeof(uint64_t), Cmp_uint64);
+    for (i = j = 0; i < n && j < BIODIFF_SKETCH_K; i++)
+        if (!j || hash[i] != hash[j - 1])
+            hash[j++] = hash[i];
+    return j;
+}
+
+/* Count_registers: the HyperLogLog estimate of the distinct keys of some registers, by
+   linear counting while many of them are still 0 */
+static double Count_registers(const unsigned char *reg)
+{
+    double m = 1 << BIODIFF_SKETCH_BITS, sum = 0, e;
+    long zeros = 0, i;
+    for (i = 0; i < m; i++)
+    {
+        sum += 1.0 / ((uint64_t) 1 << reg[i]);
+        zeros += !reg[i];
+    }
+    e = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    return e <= 2.5 * m && zeros ? m * Ln(m / zeros) : e;
+}
+
+/* Biodiff_sketch_save: write a sketch to a file after SKETCH_MAGIC */
+int Biodiff_sketch_save(Biodiff *bd, const Biodiff_sketch *sketch, const char *file_name)
+{
+    FILE *out;
+    if (!(out = fopen(file_name, "wb")))
+        return Fail(bd, "Can not create the output file %s.", file_name);
+    fwrite(SKETCH_MAGIC, 8, 1, out);
+    fwrite(sketch, sizeof(Biodiff_sketch), 1, out);
+    if (ferror(out) | fclose(out))
+        return Fail(bd, "Can not write the output file %s.", file_name);
+    return BIODIFF_OK;
+}
+
+/* Biodiff_sketch_load: read a sketch written by Biodiff_sketch_save */
+int Biodiff_sketch_load(Biodiff *bd, const char *file_name, Biodiff_sketch *sketch)
+{
+    FILE *in;
+    char magic[8];
+    int ok;
+    if (!(in = fopen(file_name, "rb")))
+        return Fail(bd, "Can not open the input file %s.", file_name);
+    ok = fread(magic, 8, 1, in) == 1 && !memcmp(magic, SKETCH_MAGIC, 8) && fread(sketch, sizeof(Biodiff_sketch), 1, in) == 1 &&
+         sketch -> k >= 0 && sketch -> k <= BIODIFF_SKETCH_K;
+    fclose(in);
+    return ok ? BIODIFF_OK : Fail(bd, "The sketch file %s is damaged.", file_name);
+}
+
+/* Biodiff_estimate: the distinct keys of each from their registers, or their count when the sketch
+   holds them all; those of either from the registers of both, the larger of each pair. The
+   smallest K hashes of either are a sample of its keys, and those in both sketches are a sample
+   of the keys of both: their share is the Jaccard index */
+int Biodiff_estimate(Biodiff *bd, const Biodiff_sketch *A, const Biodiff_sketch *B, Biodiff_similarity *estimate)
+{
+    unsigned char reg[1 << BIODIFF_SKETCH_BITS];
+    double either, error = 1.04 / Root(1 << BIODIFF_SKETCH_BITS), either_error;
+    long i = 0, j = 0, k = 0, both = 0;
+    if (A -> keys != B -> keys || A -> fold != B -> fold || memcmp(A -> type, B -> type, sizeof(A -> type)))
+        return Fail(bd, "The sketches are of keys made from other numbers of columns, types or folds.");
+    while (k < BIODIFF_SKETCH_K && (i < A -> k || j < B -> k))   /* the smallest hashes of either */
+    {
+        if (j == B -> k || (i < A -> k && A -> bottom[i] < B -> bottom[j]))
+            i++;
+        else if (i == A -> k || B -> bottom[j] < A -> bottom[i])
+            j++;
+        else
+            i++, j++, both++;
+        k++;
+    }
+    for (i = 0; i < 1 << BIODIFF_SKETCH_BITS; i++)
+        reg[i] = A -> reg[i] > B -> reg[i] ? A -> reg[i] : B -> reg[i];
+    estimate -> a = A -> k < BIODIFF_SKETCH_K ? A -> k : Count_registers(A -> reg);
+    estimate -> b = B -> k < BIODIFF_SKETCH_K ? B -> k : Count_registers(B -> reg);
+    estimate -> a_error = A -> k < BIODIFF_SKETCH_K ? 0 : estimate -> a * error;
+    estimate -> b_error = B -> k < BIODIFF_SKETCH_K ? 0 : estimate -> b * error;
+    estimate -> jaccard = k ? (double) both / k : 0;
+    if (k < BIODIFF_SKETCH_K)   /* every key of both is in the sketches */
+    {
+        either = k;
+        either_error = estimate -> jaccard_error = 0;
+    }
+    else
+    {
+        either = Count_registers(reg);
+        either_error = either * error;
+        estimate -> jaccard_error = Root(estimate -> jaccard * (1 - estimate -> jaccard) / k);
+    }
+    estimate -> both = estimate -> jaccard * either;
+    estimate -> both_error = Root(either * either * estimate -> jaccard_error * estimate -> jaccard_error +
+                                  estimate -> jaccard * estimate -> jaccard * either_error * either_error);
+    return BIODIFF_OK;
+}
+
+/* Ln: the natural logarithm, without libm: the powers of 2 taken out, then 2 atanh((x - 1) / (x + 1)) */
+static double Ln(double x)
+{
+    double y, y2, term, sum = 0;
+    int k = 0, i;
+    for (; x >= 2; x /= 2)
+        k++;
+    for (; x < 1; x *= 2)
+        k--;
+    y = (x - 1) / (x + 1);
+    y2 = y * y;
+    for (i = 1, term = y; i < 40; i += 2, term *= y2)
+        sum += term / i;
+    return 2 * sum + k * 0.69314718055994531;
+}
+
+/* Root: the square root, without libm, by Newton's steps */
+static double Root(double x)
+{
+    double r = x > 1 ? x : 1;
+    if (x <= 0)
+        return 0;
+    for (int i = 0; i < 64; i++)
+        r = (r + x / r) / 2;
+    return r;
+}
+
+/******************************************************************************/
+/* Biodiff_compare_n: find for every row of n tables which of them hold a match.
+   Keys are gathered in one hash table with a word of the tables holding each,
+   intervals of all the tables are sorted together and swept forth and back. */
+int Biodiff_compare_n(Biodiff *bd, int mode, Biodiff_table **table, int n, Biodiff_venn *venn)
+{
+    struct HashIndex *keys;
+    struct Cursor cursor;
+    char column[KEY_SIZE], *key;
+    long row;
+    int t, status = BIODIFF_OK;
+    Biodiff_venn_free(venn);
+    venn -> stat = &bd -> stat;
+    if (bd -> opt.shards > 1)
+        return Fail(bd, "Biodiff_compare_n does not split tables into shards.");
+    if (n < 1 || n > BIODIFF_MAX_TABLES)
+        return Fail(bd, "Can not compare %d tables at once, at most %d.", n, BIODIFF_MAX_TABLES);
+    if (mode == BIODIFF_OVERLAP)
+    {
+        Perf_phase(bd, BIODIFF_PHASE_READ);
+        status = c_venn(bd, table, n, venn);
+        Perf_phase(bd, -1);
+        return status;
+    }
+    if (mode != BIODIFF_EQUAL)
+        return Fail(bd, "Mode %d compares two tables only, Biodiff_compare_n takes BIODIFF_EQUAL or BIODIFF_OVERLAP.", mode);
+    if (Check_keys(bd, table, n))
+        return BIODIFF_ERROR;
+    Perf_phase(bd, BIODIFF_PHASE_BUILD);   /* the keys are read as they are counted */
+    keys = Create_hash(bd, &bd -> stat, 0);
+    keys -> member = (uint64_t *) Take_pages_zero(bd, &bd -> stat, BIODIFF_MEM_INDEX, keys -> slots, sizeof(uint64_t));
+    for (t = 0; !status && t < n; t++)   /* the tables holding every key */
+    {
+        if (!(status = Open_rows(bd, table[t], &cursor)))
+        {
+            while (Next_row(&cursor))
+            {
+                key = Row_key(&cursor, column);
+                *Member_hash(bd, keys, key, Hash_key(key)) |= (uint64_t) 1 << t;
+            }
+            status = Close_rows(bd, &cursor);
+        }
+    }
+    Perf_phase(bd, BIODIFF_PHASE_PROBE);   /* and the rows passed to the result */
+    for (t = 0; !status && t < n; t++)
+    {
+        if (!(status = Open_rows(bd, table[t], &cursor)))
+        {
+            for (row = 0; Next_row(&cursor); row++)
+            {
+                key = Row_key(&cursor, column);
+                Mark_member(venn, t, row, *Member_hash(bd, keys, key, Hash_key(key)), cursor.line);
+            }
+            status = Close_rows(bd, &cursor);
+        }
+    }
+    Free_hash(keys);
+    Perf_phase(bd, -1);
+    return status;
+}
+
+/* Cmp_venn_number: the comparison function for qsort of the intervals of c_venn, by their left end points as numbers */
+static int Cmp_venn_number(const void *a, const void *b)
+{
+    const struct Venn_interval *x = (const struct Venn_interval *) a, *y = (const struct Venn_interval *) b;
+    if (x -> interval -> left != y -> interval -> left)
+        return x -> interval -> left < y -> interval -> left ? -1 : 1;
+    return x -> table != y -> table ? x -> table - y -> table : x -> interval -> row < y -> interval -> row ? -1 : 1;
+}
+
+/* Cmp_venn_string: the comparison function for qsort of the intervals of c_venn, by their left end points as strings */
+static int Cmp_venn_string(const void *a, const void *b)
+{
+    const struct Venn_interval *x = (const struct Venn_interval *) a, *y = (const struct Venn_interval *) b;
+    int c = strcmp(x -> interval -> start, y -> interval -> start);
+    if (c)
+        return c;
+    return x -> table != y -> table ? x -> table - y -> table : x -> interval -> row < y -> interval -> row ? -1 : 1;
+}
+
+/******************************************************************************/
+/* c_venn: coordinate-based overlaps among n tables. The intervals of every table are
+   sorted together by their left end points. Forth, an interval overlaps a table whose
+   rightmost right end point so far reaches its left end point; back, it overlaps a table
+   whose next left end point is within it. Both sweeps take n steps per interval. */
+static int c_venn(Biodiff *bd, Biodiff_table **table, int n, Biodiff_venn *venn)
+{
+    struct Venn_interval *all;
+    struct Cursor cursor;
+    uint64_t *member[BIODIFF_MAX_TABLES];
+    long total = 0, i, row;
+    int t, status = BIODIFF_OK;
+    for (t = 0; t < n; t++)
+        if (!Table_intervals(bd, table[t]))
+            return BIODIFF_ERROR;
+        else
+            total += table[t] -> intervals;
+    all = (struct Venn_interval *) Take(&bd -> stat, BIODIFF_MEM_ARRAYS, sizeof(struct Venn_interval) * (total + 1));
+    for (total = t = 0; t < n; t++)
+    {
+        member[t] = (uint64_t *) Take_zero(&bd -> stat, BIODIFF_MEM_ARRAYS, table[t] -> rows + 1, sizeof(uint64_t));
+        for (i = 1; i <= table[t] -> intervals; i++, total++)
+        {
+            all[total].interval = table[t] -> interval + i;
+            all[total].table = t;
+        }
+    }
+    Perf_phase(bd, BIODIFF_PHASE_SORT);
+    qsort(all, total, sizeof(struct Venn_interval), bd -> opt.coord == BIODIFF_COORD_STRING ? Cmp_venn_string : Cmp_venn_number);
+    Perf_phase(bd, BIODIFF_PHASE_SWEEP);
+    if (bd -> opt.coord == BIODIFF_COORD_STRING)
+        Venn_sweep(all, total, n, member, BIODIFF_COORD_STRING);
+    else
+        Venn_sweep(all, total, n, member, BIODIFF_COORD_INT);
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, all, sizeof(struct Venn_interval) * (total + 1));
+
+    /* pass every row to the result with its tables */
+    Perf_phase(bd, BIODIFF_PHASE_WRITE);
+    for (t = 0; !status && t < n; t++)
+        if (!(status = Open_rows(bd, table[t], &cursor)))
+        {
+            for (row = 1; row <= table[t] -> rows && Next_row(&cursor); ++row)
+                Mark_member(venn, t, row - 1, member[t][row], cursor.line);
+            status = Close_rows(bd, &cursor);
+        }
+    for (t = 0; t < n; t++)
+        Give(&bd -> stat, BIODIFF_MEM_ARRAYS, member[t], sizeof(uint64_t) * (table[t] -> rows + 1));
+    return status;
+}
+
+/* Venn_sweep: the sweeps of c_venn over the sorted intervals, marking in member the tables
+   each one overlaps. It is inlined with a constant coord, one loop for numbers and one for strings */
+SPECIALIZE void Venn_sweep(struct Venn_interval *all, long total, int n, uint64_t **member, int coord)
+{
+    const struct Interval *reach[BIODIFF_MAX_TABLES], *interval;
+    struct Venn_interval *x;
+    int j;
+    memset(reach, 0, sizeof(reach));   /* the interval of every table reaching furthest right so far */
+    for (x = all; x < all + total; x++)
+    {
+        interval = x -> interval;
+        member[x -> table][interval -> row] |= (uint64_t) 1 << x -> table;
+        for (j = 0; j < n; j++)
+            if (j != x -> table && reach[j] && Cmp_coord(coord, reach[j], 1, interval) >= 0)
+                member[x -> table][interval -> row] |= (uint64_t) 1 << j;
+        if (!reach[x -> table] || (coord == BIODIFF_COORD_STRING ?
+            strcmp(interval -> end, reach[x -> table] -> end) > 0 : interval -> right > reach[x -> table] -> right))
+            reach[x -> table] = interval;
+    }
+    memset(reach, 0, sizeof(reach));   /* the next interval of every table */
+    for (x = all + total - 1; x >= all; x--)
+    {
+        interval = x -> interval;
+        for (j = 0; j < n; j++)
+            if (j != x -> table && reach[j] && Cmp_coord(coord, interval, 1, reach[j]) >= 0)
+                member[x -> table][interval -> row] |= (uint64_t) 1 << j;
+        reach[x -> table] = interval;
+    }
+}
+
+/******************************************************************************/
+/* Hash_key: hash a key string for the Bloom filter (FNV-1a with a final mix) */
+static uint64_t Hash_key(char *str)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (; *str; str++)
+    {
+        h ^= (unsigned char) *str;
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 33;                  /* spread the low bits over the whole word */
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/******************************************************************************/
+/* Push_hash: append a key hash to a list */
+static void Push_hash(Biodiff_stats *stat, struct Hashes *list, uint64_t h)
+{
+    if (list -> n == list -> size)
+    {
+        list -> hash = (uint64_t *) Retake(stat, BIODIFF_MEM_INDEX, list -> hash, sizeof(uint64_t) * list -> size,
+                                           sizeof(uint64_t) * (list -> size ? list -> size * 2 : 1024));
+        list -> size = list -> size ? list -> size * 2 : 1024;
+    }
+    list -> hash[list -> n++] = h;
+}
+
+/******************************************************************************/
+/* Create_bloom: create a Bloom filter for a list of key hashes at the target false-positive rate.
+   The list is released once its hashes are in the filter. */
+static Bloom *Create_bloom(Biodiff *bd, Biodiff_stats *stat, struct Hashes *list, double fpr)
+{
+    Bloom *filter = (Bloom *) Take(stat, BIODIFF_MEM_INDEX, sizeof(Bloom));
+    double bits = 0, q = fpr;
+    long i;
+    while (q < 0.5)                /* bits per key = log2(1/fpr) / ln 2 */
+    {
+        q *= 2;
+        bits += 1;
+    }
+    bits = (bits + 2 * (1 - q)) * 1.44 * 1.2;   /* a fifth more bits make up for the blocking */
+    filter -> k = (int) (bits * 0.69 + 0.5);
+    if (filter -> k < 1)
+        filter -> k = 1;
+    if (filter -> k > 16)
+        filter -> k = 16;
+    filter -> blocks = (uint64_t) (bits * list -> n) / (64 * BLOOM_BLOCK) + 1;
+    filter -> bits = (uint64_t *) Take_pages_zero(bd, stat, BIODIFF_MEM_INDEX, filter -> blocks * BLOOM_BLOCK, sizeof(uint64_t));
+    for (i = 0; i < list -> n; i++)
+    {
+        uint64_t *block = filter -> bits + list -> hash[i] % filter -> blocks * BLOOM_BLOCK;
+        uint32_t h1 = (uint32_t) list -> hash[i], h2 = (uint32_t) (list -> hash[i] >> 32) | 1;
+        for (int j = 0; j < filter -> k; j++, h1 += h2)
+            block[(h1 >> 6) % BLOOM_BLOCK] |= 1ULL << (h1 & 63);
+    }
+    Give(stat, BIODIFF_MEM_INDEX, list -> hash, sizeof(uint64_t) * list -> size);
+    list -> hash = NULL;
+    list -> n = list -> size = 0;
+    return filter;
+}
+
+/******************************************************************************/
+/* Search_bloom: whether a key hash may be in the filter */
+static int Search_bloom(Bloom *filter, uint64_t h)
+{
+    uint64_t *block = filter -> bits + h % filter -> blocks * BLOOM_BLOCK;
+    uint32_t h1 = (uint32_t) h, h2 = (uint32_t) (h >> 32) | 1;
+    for (int j = 0; j < filter -> k; j++, h1 += h2)
+        if (!(block[(h1 >> 6) % BLOOM_BLOCK] & 1ULL << (h1 & 63)))
+            return NOTEXIST;
+    return EXIST;
+}
+
+/******************************************************************************/
+/* Free_bloom: release a Bloom filter */
+static void Free_bloom(Biodiff_stats *stat, Bloom *filter)
+{
+    if (!filter)
+        return;
+    Give_pages(stat, BIODIFF_MEM_INDEX, filter -> bits, sizeof(uint64_t) * filter -> blocks * BLOOM_BLOCK);
+    Give(stat, BIODIFF_MEM_INDEX, filter, sizeof(Bloom));
+}
+
+/******************************************************************************/
+/* Create_hash: create an empty hash table of key strings, room for n keys */
+static struct HashIndex *Create_hash(Biodiff *bd, Biodiff_stats *stat, long n)
+{
+    struct HashIndex *table = (struct HashIndex *) Take(stat, BIODIFF_MEM_INDEX, sizeof(struct HashIndex));
+    for (table -> slots = 1024; table -> slots < 2 * n; table -> slots *= 2)
+        ;                                   /* keep the load under one half */
+    table -> hash = (uint64_t *) Take_pages_zero(bd, stat, BIODIFF_MEM_INDEX, table -> slots, sizeof(uint64_t));
+    table -> key = (long *) Take_pages(bd, stat, BIODIFF_MEM_INDEX, sizeof(long) * table -> slots);
+    table -> size = 16 * table -> slots;
+    table -> pool = (char *) Take_pages(bd, stat, BIODIFF_MEM_INDEX, table -> size);
+    table -> used = table -> n = 0;
+    table -> member = NULL;
+    table -> stat = stat;
+    return table;
+}
+
+/* Grow_hash: double the table size and reinsert every slot */
+static void Grow_hash(Biodiff *bd, struct HashIndex *table)
+{
+    uint64_t *hash = table -> hash, *member = table -> member;
+    long *key = table -> key, slots = table -> slots, i, j;
+    table -> slots *= 2;
+    table -> hash = (uint64_t *) Take_pages_zero(bd, table -> stat, BIODIFF_MEM_INDEX, table -> slots, sizeof(uint64_t));
+    table -> key = (long *) Take_pages(bd, table -> stat, BIODIFF_MEM_INDEX, sizeof(long) * table -> slots);
+    if (member)
+        table -> member = (uint64_t *) Take_pages(bd, table -> stat, BIODIFF_MEM_INDEX, sizeof(uint64_t) * table -> slots);
+    for (i = 0; i < slots; i++)
+        if (hash[i])
+        {
+            for (j = hash[i] & (table -> slots - 1); table -> hash[j]; j = (j + 1) & (table -> slots - 1))
+                ;
+            table -> hash[j] = hash[i];
+            table -> key[j] = key[i];
+            if (member)
+                table -> member[j] = member[i];
+        }
+    Give_pages(table -> stat, BIODIFF_MEM_INDEX, hash, sizeof(uint64_t) * slots);
+    Give_pages(table -> stat, BIODIFF_MEM_INDEX, key, sizeof(long) * slots);
+    Give_pages(table -> stat, BIODIFF_MEM_INDEX, member, sizeof(uint64_t) * slots);
+}
+
+/******************************************************************************/
+/* Insert_hash: insert a key string with its hash to the hash table */
+static void Insert_hash(Biodiff *bd, struct HashIndex *table, char *str, uint64_t h)
+{
+    long i, len, size;
+    h = h ? h : 1;                          /* 0 marks an empty slot */
+    for (i = h & (table -> slots - 1); table -> hash[i]; i = (i + 1) & (table -> slots - 1))
+        if (table -> hash[i] == h && !strcmp(table -> pool + table -> key[i], str))
+            return;                         /* inserted already */
+    len = strlen(str) + 1;
+    if (table -> used + len > table -> size)
+    {
+        size = table -> size;
+        while (table -> used + len > table -> size)
+            table -> size *= 2;
+        table -> pool = (char *) Retake_pages(bd, table -> stat, BIODIFF_MEM_INDEX, table -> pool, size, table -> size);
+    }
+    memcpy(table -> pool + table -> used, str, len);
+    table -> hash[i] = h;
+    table -> key[i] = table -> used;
+    if (table -> member)
+        table -> member[i] = 0;
+    table -> used += len;
+    if (++table -> n * 2 > table -> slots)
+        Grow_hash(bd, table);
+}
+
+/******************************************************************************/
+/* Search_hash: search for a key string in the hash table based on total equal */
+static int Search_hash(struct HashIndex *table, char *str, uint64_t h)
+{
+    long i;
+    h = h ? h : 1;
+    for (i = h & (table -> slots - 1); table -> hash[i]; i = (i + 1) & (table -> slots - 1))
+        if (table -> hash[i] == h && !strcmp(table -> pool + table -> key[i], str))
+            return EXIST;
+    return NOTEXIST;
+}
+
+/* Member_hash: the word of the tables holding a key, the key inserted when it is new */
+static uint64_t *Member_hash(Biodiff *bd, struct HashIndex *table, char *str, uint64_t h)
+{
+    long i;
+    Insert_hash(bd, table, str, h);
+    h = h ? h : 1;
+    for (i = h & (table -> slots - 1); table -> hash[i] != h || strcmp(table -> pool + table -> key[i], str); i = (i + 1) & (table -> slots - 1))
+        ;
+    return table -> member + i;
+}
+
+/******************************************************************************/
+/* Free_hash: release a hash table */
+static void Free_hash(struct HashIndex *table)
+{
+    Biodiff_stats *stat = table -> stat;
+    Give_pages(stat, BIODIFF_MEM_INDEX, table -> member, sizeof(uint64_t) * table -> slots);
+    Give_pages(stat, BIODIFF_MEM_INDEX, table -> hash, sizeof(uint64_t) * table -> slots);
+    Give_pages(stat, BIODIFF_MEM_INDEX, table -> key, sizeof(long) * table -> slots);
+    Give_pages(stat, BIODIFF_MEM_INDEX, table -> pool, table -> size);
+    Give(stat, BIODIFF_MEM_INDEX, table, sizeof(struct HashIndex));
+}
+
+/******************************************************************************/
+/* Free_arena: release the nodes of a whole trie tree, a chunk at a time */
+static void Free_arena(struct Arena *arena)
+{
+    char *chunk;
+    while ((chunk = arena -> chunk))
+    {
+        arena -> chunk = *(char **) chunk;
+        Give_pages(arena -> stat, BIODIFF_MEM_INDEX, chunk, HUGE_PAGE);
+    }
+}
+
+/******************************************************************************/
+/* Index_create: create an empty key index with an engine */
+static Index *Index_create(Biodiff *bd, Biodiff_stats *stat, int engine, int mode)
+{
+    Index *index = (Index *) Take_zero(stat, BIODIFF_MEM_INDEX, 1, sizeof(Index));
+    index -> engine = engine;
+    index -> mode = mode;
+    index -> stat = index -> arena.stat = stat;
+    if (mode == 2)
+        index -> build = Create_radix(stat);     /* prefixes need the radix tree */
+    else if (engine == ENGINE_HASH)
+        index -> table = Create_hash(bd, stat, 0);
+    else
+        index -> trie = Create_tire(bd, &index -> arena);
+    return index;
+}
+
+/******************************************************************************/
+/* Index_insert: insert a key to the index */
+static void Index_insert(Biodiff *bd, Index *index, char *str)
+{
+    uint64_t h = 0;
+    if (!str)
+        return;   /* a row outside the shard */
+    if (index -> build)
+    {
+        Insert_radix(index -> stat, index -> build, str);
+        return;
+    }
+    if (index -> table || bd -> opt.bloom_fpr)
+        h = Hash_key(str);
+    if (index -> table)
+        Insert_hash(bd, index -> table, str, h);
+    else
+        Insert_trie(bd, &index -> arena, index -> trie, str);
+    if (bd -> opt.bloom_fpr)
+        Push_hash(index -> stat, &index -> hashes, h);
+}
+
+/******************************************************************************/
+/* Index_ready: finish building the index before it is searched, BIODIFF_ERROR when
+   a trie lost keys for want of memory */
+static int Index_ready(Biodiff *bd, Index *index)
+{
+    if (index -> arena.failed)
+        return Fail(bd, "Can not take the memory of a trie.");
+    if (index -> build)
+    {
+        index -> radix = Freeze_radix(bd, index -> stat, index -> build);
+        index -> build = NULL;
+    }
+    else if (bd -> opt.bloom_fpr)   /* a prefix can not be rejected by a Bloom filter */
+        index -> bloom = Create_bloom(bd, index -> stat, &index -> hashes, bd -> opt.bloom_fpr);
+    if (bd -> opt.shape && index -> radix)
+        Shape_radix(index -> stat, index -> radix);
+    else if (bd -> opt.shape && index -> trie)
+        Shape_trie(index -> stat, index -> trie, 0);
+    return BIODIFF_OK;
+}
+
+/******************************************************************************/
+/* Index_search: search for a key in the index, consulting its Bloom filter first */
+static int Index_search(Biodiff *bd, Index *index, char *str)
+{
+    uint64_t h = 0;
+    int found;
+    if (!str)
+        return NOTEXIST;
+    if (index -> radix)
+        return Search_radix(index -> radix, str);
+    if (index -> table || index -> bloom)
+        h = Hash_key(str);
+    if (index -> bloom)
+    {
+        bd -> stat.bloom_probes++;
+        if (!Search_bloom(index -> bloom, h))
+        {
+            bd -> stat.bloom_rejects++;   /* rejected with one cache line */
+            return NOTEXIST;
+        }
+    }
+    found = index -> table ? Search_hash(index -> table, str, h) : Search_trie1(index -> trie, str);
+    if (index -> bloom && !found)
+        bd -> stat.bloom_false++;
+    return found;
+}
+
+/******************************************************************************/
+/* Step_trie: advance a trie lookup by one node, 1 when it is done */
+static int Step_trie(struct Probe *probe)
+{
+    TrieNode *next;
+    int i = *probe -> str;
+    if (!i)
+    {
+        probe -> found = probe -> trie -> exist;
+        return 1;
+    }
+    if (!(next = probe -> trie -> next[i]))
+        return 1;              /* not match */
+    probe -> trie = next;
+    i = *++probe -> str;
+    PREFETCH(i ? (void *) &next -> next[i] : (void *) &next -> exist);   /* the word read next */
+    return 0;
+}
+
+/* Step_hash: advance a hash lookup by one slot or one key comparison, 1 when it is done */
+static int Step_hash(struct HashIndex *table, struct Probe *probe)
+{
+    long mask = table -> slots - 1;
+    if (probe -> stage)        /* a slot with an equal hash, its key is in cache now */
+    {
+        probe -> stage = 0;
+        if (!strcmp(table -> pool + table -> key[probe -> slot], probe -> str))
+        {
+            probe -> found = EXIST;
+            return 1;
+        }
+        probe -> slot = (probe -> slot + 1) & mask;
+        PREFETCH(table -> hash + probe -> slot);
+        return 0;
+    }
+    for (; table -> hash[probe -> slot]; probe -> slot = (probe -> slot + 1) & mask)
+        if (table -> hash[probe -> slot] == probe -> h)
+        {
+            probe -> stage = 1;
+            PREFETCH(table -> pool + table -> key[probe -> slot]);
+            return 0;
+        }
+    return 1;                  /* an empty slot: not match */
+}
+
+/* Step_radix: advance a radix tree lookup by one node, in two steps: the slot of the
+   node, then its label run and the first bytes of its children. 1 when it is done. */
+static int Step_radix(RadixTree *tree, struct Probe *probe)
+{
+    struct RadixSlot *node = tree -> slot + probe -> slot;
+    char *label = tree -> labels + node -> label;
+    int k;
+    if (!probe -> stage)       /* the slot is in cache */
+    {
+        PREFETCH(label);
+        PREFETCH(tree -> key + node -> first);
+        probe -> stage = 1;
+        return 0;
+    }
+    if (probe -> slot)         /* the root has no label run */
+    {
+        for (k = 1; k < node -> len && probe -> str[k]; k++)
+            if (probe -> str[k] != label[k])
+                return 1;      /* not match inside the label run */
+        if (k < node -> len || !probe -> str[k])
+        {
+            probe -> found = EXIST;   /* the string ends inside or at the end of the label run */
+            return 1;
+        }
+        probe -> str += k;
+    }
+    else if (!*probe -> str)
+    {
+        probe -> found = EXIST;   /* the empty string is a prefix of every key */
+        return 1;
+    }
+    if ((probe -> slot = Find_radix(tree, node, (unsigned char) *probe -> str)) < 0)
+        return 1;              /* not match */
+    PREFETCH(tree -> slot + probe -> slot);
+    probe -> stage = 0;
+    return 0;
+}
+
+/******************************************************************************/
+/* Index_probe: search for a batch of keys at once, as Index_search does for each.
+   The lookups advance in turn, one node each, and every step prefetches what its
+   lookup reads next, so the cache misses of the whole batch are in flight together
+   instead of one after the other. */
+static void Index_probe(Biodiff *bd, Index *index, char **key, int n, int *found)
+{
+    struct Probe probe[PROBE_BATCH];
+    int i, live = 0;
+    if (n == 1)
+    {
+        *found = Index_search(bd, index, *key);   /* nothing to overlap */
+        return;
+    }
+    for (i = 0; i < n; i++)
+    {
+        probe[i].str = key[i];
+        probe[i].found = NOTEXIST;
+        probe[i].stage = key[i] ? 0 : -1;
+        probe[i].done = !key[i];   /* a row outside the shard */
+        if (key[i] && (index -> table || index -> bloom))
+        {
+            probe[i].h = Hash_key(key[i]);
+            if (index -> bloom)
+                PREFETCH(index -> bloom -> bits + probe[i].h % index -> bloom -> blocks * BLOOM_BLOCK);
+        }
+    }
+    for (i = 0; i < n; i++)
+    {
+        if (probe[i].done)
+            continue;
+        if (index -> bloom)
+        {
+            bd -> stat.bloom_probes++;
+            if (!Search_bloom(index -> bloom, probe[i].h))
+            {
+                bd -> stat.bloom_rejects++;   /* rejected with one cache line */
+                probe[i].done = 1;
+                probe[i].stage = -1;
+                continue;
+            }
+        }
+        if (index -> radix)
+            probe[i].slot = 0, probe[i].stage = 1;   /* the root is in cache */
+        else if (index -> table)
+        {
+            probe[i].h = probe[i].h ? probe[i].h : 1;   /* 0 marks an empty slot */
+            probe[i].slot = probe[i].h & (index -> table -> slots - 1);
+            PREFETCH(index -> table -> hash + probe[i].slot);
+            PREFETCH(index -> table -> key + probe[i].slot);
+        }
+        else
+        {
+            probe[i].trie = index -> trie;
+            PREFETCH(&index -> trie -> next[(int) *key[i]]);
+        }
+        live++;
+    }
+    if (index -> radix)   /* the engine is chosen once a batch, not at every step */
+        Run_probes(index, probe, n, live, PROBE_RADIX);
+    else if (index -> table)
+        Run_probes(index, probe, n, live, PROBE_HASH);
+    else
+        Run_probes(index, probe, n, live, PROBE_TRIE);
+    for (i = 0; i < n; i++)
+    {
+        found[i] = probe[i].found;
+        if (index -> bloom && !found[i] && probe[i].stage >= 0)
+            bd -> stat.bloom_false++;
+    }
+}
+
+/* Run_probes: advance every live lookup of a batch by a step in turn until all are done.
+   It is inlined with a constant engine, so each engine has a loop of its own steps */
+SPECIALIZE void Run_probes(Index *index, struct Probe *probe, int n, int live, int engine)
+{
+    int i;
+    while (live)
+        for (i = 0; i < n; i++)
+            if (!probe[i].done &&
+                (engine == PROBE_RADIX ? Step_radix(index -> radix, probe + i) :
+                 engine == PROBE_HASH ? Step_hash(index -> table, probe + i) : Step_trie(probe + i)))
+            {
+                probe[i].done = 1;
+                live--;
+            }
+}
+
+/******************************************************************************/
+/* Index_free: release the index */
+static void Index_free(Index *index)
+{
+    Biodiff_stats *stat = index -> stat;
+    Free_arena(&index -> arena);
+    if (index -> table)
+        Free_hash(index -> table);
+    if (index -> build)
+        Drop_radix(stat, index -> build);
+    if (index -> radix)
+        Free_radix(stat, index -> radix);
+    Free_bloom(stat, index -> bloom);
+    Give(stat, BIODIFF_MEM_INDEX, index -> hashes.hash, sizeof(uint64_t) * index -> hashes.size);
+    Give(stat, BIODIFF_MEM_INDEX, index, sizeof(Index));
+}
+
+/******************************************************************************/
+/* Shape_trie: count the nodes of a trie by their depth and by their children */
+static void Shape_trie(Biodiff_stats *stat, TrieNode *node, int depth)
+{
+    int i, children = 0;
+    for (i = 0; i < BRANCH_SIZE; i++)
+        if (node -> next[i])
+        {
+            children++;
+            Shape_trie(stat, node -> next[i], depth + 1);
+        }
+    stat -> trie_nodes++;
+    stat -> trie_depth[depth < BIODIFF_DEPTHS ? depth : BIODIFF_DEPTHS - 1]++;
+    stat -> trie_fanout[children < BIODIFF_FANOUTS ? children : BIODIFF_FANOUTS - 1]++;
+}
+
+/* Shape_radix: count the nodes of a radix tree by their depth, the key bytes
+   above their ends, and by their children; the nodes are breadth-first, so the
+   depth of every parent is known before its children. */
+static void Shape_radix(Biodiff_stats *stat, RadixTree *tree)
+{
+    int *depth = (int *) Take(stat, BIODIFF_MEM_ARRAYS, sizeof(int) * tree -> nodes), i, j, d;
+    struct RadixSlot *node;
+    depth[0] = 0;
+    for (i = 0; i < tree -> nodes; i++)
+    {
+        node = tree -> slot + i;
+        for (j = node -> first; j < node -> first + node -> nchild; j++)
+            depth[j] = depth[i] + tree -> slot[j].len;
+        d = depth[i];
+        stat -> trie_nodes++;
+        stat -> trie_depth[d < BIODIFF_DEPTHS ? d : BIODIFF_DEPTHS - 1]++;
+        stat -> trie_fanout[node -> nchild < BIODIFF_FANOUTS ? node -> nchild : BIODIFF_FANOUTS - 1]++;
+    }
+    Give(stat, BIODIFF_MEM_ARRAYS, depth, sizeof(int) * tree -> nodes);
+}
+
+/******************************************************************************/
+/* Count_trie: count the nodes of a trie tree */
+static long Count_trie(TrieNode *root)
+{
+    long n = 1;
+    for (int i = 0; i < BRANCH_SIZE; i++)
+        if (root -> next[i])
+            n += Count_trie(root -> next[i]);
+    return n;
+}
+
+/******************************************************************************/
+/* Sample_file: estimate the rows and the key shape of a table from its first rows */
+static int Sample_file(Biodiff *bd, Biodiff_table *table, int trie, struct Sample *sample)
+{
+    struct Cursor cursor;
+    char column[KEY_SIZE], *key;
+    double bytes = 0, keys = 0;
+    int rows = 0;
+    Reader *file = table -> reader;
+    struct Arena arena = {NULL, 0, &bd -> stat, 0};
+    TrieNode *root;
+    if (Open_rows(bd, table, &cursor))
+        return BIODIFF_ERROR;
+    root = trie ? Create_tire(bd, &arena) : NULL;
+    while (rows < SAMPLE_ROWS && Next_row(&cursor))
+    {
+        bytes += strlen(cursor.line);
+        keys += strlen(key = Row_key(&cursor, column));
+        if (root)
+            Insert_trie(bd, &arena, root, key);
+        rows++;
+    }
+    /* a buffer knows its rows, the decoded size of a compressed file follows from
+       the ratio seen so far, a pipe has no size and only its sampled rows are counted */
+    if (!rows)
+        sample -> rows = 0;
+    else if (table -> data)
+        sample -> rows = table -> rows;
+    else if (file && file -> size && file -> in)
+        sample -> rows = file -> size * (file -> out / file -> in) / (bytes / rows);
+    else
+        sample -> rows = rows;
+    sample -> key = rows ? keys / rows : 0;
+    /* shared prefixes grow with the number of keys, so this is an upper bound */
+    sample -> nodes = root && rows ? (Count_trie(root) - 1.0) / rows : 0;
+    Free_arena(&arena);
+    if (arena.failed)
+        return Fail(bd, "Can not take the memory of a trie.");
+    return file && file -> error ? Fail(bd, "Can not decompress the input files.") : BIODIFF_OK;
+}
+
+/* Show_size: format a number of bytes for the plan */
+static char *Show_size(double bytes, char *buffer)
+{
+    const char *unit[] = {"B", "KB", "MB", "GB", "TB"};
+    int i;
+    for (i = 0; i < 4 && bytes >= 1024; i++)
+        bytes /= 1024;
+    sprintf(buffer, "%.1f %s", bytes, unit[i]);
+    return buffer;
+}
+
+/******************************************************************************/
+/* Biodiff_plan: estimate the footprint of every engine and choose one within the memory limit.
+   Only the first SAMPLE_ROWS rows of each table are read; the row count comes from the file size. */
+int Biodiff_plan(Biodiff *bd, int mode, Biodiff_table *fileA, Biodiff_table *fileB)
+{
+    struct Sample A, B;
+    int exact = mode != BIODIFF_PREFIX && mode != BIODIFF_APPROX;
+    double trie, hash, rows, parts, bloom = 0, limit = bd -> opt.mem_limit;
+    char s1[32], s2[32], s3[32];
+    if (Sample_file(bd, fileA, exact, &A) || Sample_file(bd, fileB, exact, &B))
+        return BIODIFF_ERROR;
+    rows = A.rows + B.rows;
+    Report(bd, "Plan: about %.0f rows in fileA and %.0f rows in fileB, keys of %.1f and %.1f bytes",
+           A.rows, B.rows, A.key, B.key);
+    if ((!fileA -> data && !(fileA -> reader && fileA -> reader -> size)) ||
+        (!fileB -> data && !(fileB -> reader && fileB -> reader -> size)))
+        Report(bd, "Plan: the size of a pipe is unknown, only its sampled rows are counted");
+    if (mode == BIODIFF_OVERLAP)
+    {
+        /* two stored columns with their pointers and malloc headers, the index and the adjoint vector */
+        trie = rows * (2 * (sizeof(char *) + 16) + A.key + 2 + 2 * sizeof(int));
+        if (trie <= limit)
+            Report(bd, "Plan: in-memory sweep, needs %s within the limit of %s",
+                   Show_size(trie, s1), Show_size(limit, s2));
+        else
+            Report(bd, "Plan: in-memory sweep, needs %s over the limit of %s: [-co] has no out-of-core engine",
+                   Show_size(trie, s1), Show_size(limit, s2));
+        return BIODIFF_OK;
+    }
+    if (bd -> opt.bloom_fpr && exact)
+        bloom = rows * 2;   /* about 16 bits per key */
+    if (exact)
+    {
+        /* both indices are alive while fileB is searched */
+        trie = (A.rows * A.nodes + B.rows * B.nodes) * sizeof(TrieNode) + bloom;
+        hash = rows * 2 * (sizeof(uint64_t) + sizeof(long)) + A.rows * (A.key + 1) + B.rows * (B.key + 1) + bloom;
+    }
+    else
+    {
+        /* build nodes of fileB's radix tree next to the frozen radix tree of fileA */
+        trie = hash = A.rows * (2 * (sizeof(struct RadixSlot) + 1) + A.key)
+                    + B.rows * (2 * (sizeof(RadixNode) + 2 * sizeof(RadixNode *) + 16) + B.key + 16);
+    }
+    if (mode == BIODIFF_APPROX)
+    {
+        Report(bd, "Plan: in-memory radix trees, need %s %s the limit of %s%s", Show_size(trie, s1),
+               trie <= limit ? "within" : "over", Show_size(limit, s2), trie <= limit ? "" : ": [-na] has no out-of-core engine");
+        return BIODIFF_OK;
+    }
+    if (bd -> opt.engine)
+        Report(bd, "Plan: --engine given, the limit is not applied");
+    else if (trie <= limit)
+        Report(bd, "Plan: in-memory %s, needs %s within the limit of %s",
+               exact ? "trie" : "radix tree", Show_size(trie, s1), Show_size(limit, s2));
+    else if (exact && hash <= limit)
+    {
+        bd -> opt.engine = ENGINE_HASH;
+        Report(bd, "Plan: in-memory hash table, needs %s within the limit of %s (the trie needs %s)",
+               Show_size(hash, s1), Show_size(limit, s2), Show_size(trie, s3));
+    }
+    else
+    {
+        bd -> opt.engine = ENGINE_PARTITION;
+        /* one partition pair is in memory at a time, keep it within half the limit */
+        parts = hash / (limit / 2) + 1;
+        bd -> opt.partitions = parts < 2 ? 2 : parts > MAX_PARTITIONS ? MAX_PARTITIONS : (int) parts;
+        Report(bd, "Plan: %d partitions on disk, the in-memory %s needs %s over the limit of %s",
+               bd -> opt.partitions, exact ? "hash table" : "radix tree", Show_size(hash, s1), Show_size(limit, s2));
+        if (!exact)
+            Report(bd, "Plan: prefix keys are split on their first character, partitions may be uneven");
+        if (hash / bd -> opt.partitions > limit)
+            Report(bd, "Plan: warning, a partition may still exceed the limit");
+    }
+    return BIODIFF_OK;
+}
+
+/******************************************************************************/
+/* Row_key: the key of the current row of a pass. A columnar table has its values
+   ready, and a key of one column is not even copied. */
+static char *Row_key(struct Cursor *cursor, char *key)
+{
+    Biodiff_table *table = cursor -> table;
+    char *value = key;
+    if (table -> keys > 1 || table -> type[0])
+        return Encode_key(cursor, key);
+    if (table -> columns)
+        value = Column_value(table -> columns, table -> col[0], cursor -> row - 1);   /* Next_row has moved past it */
+    else
+    {
+        *key = 0;
+        Get_col(cursor -> line, key, SEPARATORS, table -> col[0]);
+    }
+    return cursor -> fold ? Fold_key(value, key, cursor -> fold) : value;
+}
+
+/* Encode_key: the key of the current row from its columns in turn, so that it is found by
+   one hash like a key of one column. A number is 11 bytes of 6 bits, all 64 of its bits in the
+   order of the numbers; a string has its length before it in 2 bytes, but for the last column, so
+   that a key is a prefix of another only when its last column is. A value of a number column that
+   is not a whole number is kept as a string with its length, whose first byte no number has.
+   Every byte is from 1 to 127, as a trie takes them.
+   A key that would not fit in KEY_SIZE, as when a column is taken again, is cut and fails the pass */
+static char *Encode_key(struct Cursor *cursor, char *key)
+{
+    Biodiff_table *table = cursor -> table;
+    char value[LINE_BUFFER], *c = key, *end = key + KEY_SIZE - 1, *v, *rest;
+    long long number;
+    uint64_t x;
+    int i, k, len, fold, counted;
+    for (i = 0; i < table -> keys; i++)
+    {
+        if (table -> columns)
+            v = Column_value(table -> columns, table -> col[i], cursor -> row - 1);
+        else
+        {
+            *(v = value) = 0;
+            Get_col(cursor -> line, value, SEPARATORS, table -> col[i]);
+        }
+        counted = i + 1 < table -> keys;
+        if (table -> type[i] & BIODIFF_KEY_INT)
+        {
+            errno = 0;
+            number = strtoll(v, &rest, 10);
+            if (*v && !*rest && !errno)
+            {
+                if (end - c < 11)
+                {
+                    cursor -> long_key = 1;
+                    break;
+                }
+                x = (uint64_t) number ^ 0x8000000000000000ULL;   /* the negative numbers first */
+                for (k = 60; k >= 0; k -= 6)
+                    *c++ = 0x40 | (x >> k & 63);
+                continue;
+            }
+            counted = 1;   /* as "NA": a string, never equal to a number */
+        }
+        else if ((fold = cursor -> fold | (table -> type[i] & BIODIFF_KEY_FOLD ? BIODIFF_FOLD_CASE : 0)))
+            v = Fold_key(v, value, fold);
+        len = strlen(v);
+        if (end - c < len + (counted ? 2 : 0))
+        {
+            cursor -> long_key = 1;
+            break;
+        }
+        if (counted)
+        {
+            *c++ = 1 + len / 127;
+            *c++ = 1 + len % 127;
+        }
+        memcpy(c, v, len);
+        c += len;
+    }
+    *c = 0;
+    return key;
+}
+
+/* Check_keys: whether the keys of n tables are made alike, the same number of columns of the same
+   types; otherwise no two keys could be equal */
+static int Check_keys(Biodiff *bd, Biodiff_table **table, int n)
+{
+    for (int t = 1; t < n; t++)
+        if (table[t] -> keys != table[0] -> keys)
+            return Fail(bd, "The keys of the tables take %d and %d columns.", table[0] -> keys, table[t] -> keys);
+        else if (memcmp(table[t] -> type, table[0] -> type, sizeof(int) * table[0] -> keys))
+            return Fail(bd, "The key columns of the tables are of other types.");
+    return BIODIFF_OK;
+}
+
+/* Fold_key: fold the case of a key to lower case, or drop its version suffix:
+   a '.' and digits at its end, as in ENST00000357654.3 */
+static char *Fold_key(char *value, char *key, int fold)
+{
+    char *c, *dot = NULL;
+    if (value != key)
+        strcpy(key, value);   /* a value of a columnar table is not changed in place */
+    for (c = key; *c; c++)
+    {
+        if ((fold & BIODIFF_FOLD_CASE) && *c >= 'A' && *c <= 'Z')
+            *c += 'a' - 'A';
+        if (*c == '.')
+            dot = c;
+        else if (*c < '0' || *c > '9')
+            dot = NULL;       /* not a version */
+    }
+    if ((fold & BIODIFF_FOLD_VERSION) && dot && dot[1])
+        *dot = 0;
+    return key;
+}
+
+/******************************************************************************/
+/* Pool_worker: run the iterations of every parallel loop until the pool quits */
+static void *Pool_worker(void *arg)
+{
+    Pool *pool = (Pool *) arg;
+    int round = 0, i;
+    pthread_mutex_lock(&pool -> lock);
+    for (;;)
+    {
+        while (pool -> round == round && !pool -> quit)
+            pthread_cond_wait(&pool -> start, &pool -> lock);
+        if (pool -> quit)
+            break;
+        round = pool -> round;
+        while (pool -> next < pool -> count)
+        {
+            i = pool -> next++;
+            pthread_mutex_unlock(&pool -> lock);
+            pool -> job(pool -> arg, i);
+            pthread_mutex_lock(&pool -> lock);
+            if (++pool -> finished == pool -> count)
+                pthread_cond_broadcast(&pool -> done);
+        }
+    }
+    pthread_mutex_unlock(&pool -> lock);
+    return NULL;
+}
+
+/******************************************************************************/
+/* Create_pool: start a pool of threads, the caller of Pool_for being one of them */
+static Pool *Create_pool(int threads)
+{
+    Pool *pool = (Pool *) calloc(1, sizeof(Pool));
+    pool -> threads = threads - 1;
+    pool -> thread = (pthread_t *) malloc(sizeof(pthread_t) * threads);
+    pthread_mutex_init(&pool -> lock, NULL);
+    pthread_cond_init(&pool -> start, NULL);
+    pthread_cond_init(&pool -> done, NULL);
+    for (int i = 0; i < pool -> threads; i++)
+        pthread_create(&pool -> thread[i], NULL, Pool_worker, pool);
+    return pool;
+}
+
+/******************************************************************************/
+/* Pool_for: run job(arg, i) for i from 0 to count-1 on the pool, serially without one */
+static void Pool_for(Pool *pool, void (*job)(void *arg, int i), void *arg, int count)
+{
+    int i;
+    if (!pool)
+    {
+        for (i = 0; i < count; i++)
+            job(arg, i);
+        return;
+    }
+    pthread_mutex_lock(&pool -> lock);
+    pool -> job = job;
+    pool -> arg = arg;
+    pool -> next = pool -> finished = 0;
+    pool -> count = count;
+    pool -> round++;
+    pthread_cond_broadcast(&pool -> start);
+    while (pool -> next < pool -> count)   /* the caller takes iterations too */
+    {
+        i = pool -> next++;
+        pthread_mutex_unlock(&pool -> lock);
+        job(arg, i);
+        pthread_mutex_lock(&pool -> lock);
+        ++pool -> finished;
+    }
+    while (pool -> finished < pool -> count)
+        pthread_cond_wait(&pool -> done, &pool -> lock);
+    pthread_mutex_unlock(&pool -> lock);
+}
+
+/******************************************************************************/
+/* Free_pool: stop the threads and release the pool */
+static void Free_pool(Pool *pool)
+{
+    pthread_mutex_lock(&pool -> lock);
+    pool -> quit = 1;
+    pthread_cond_broadcast(&pool -> start);
+    pthread_mutex_unlock(&pool -> lock);
+    for (int i = 0; i < pool -> threads; i++)
+        pthread_join(pool -> thread[i], NULL);
+    pthread_mutex_destroy(&pool -> lock);
+    pthread_cond_destroy(&pool -> start);
+    pthread_cond_destroy(&pool -> done);
+    free(pool -> thread);
+    free(pool);
+}
+
+/******************************************************************************/
+/* Raw_fill: move the undecoded bytes to the front and read from fd until raw is full */
+static size_t Raw_fill(Reader *file)
+{
+    ssize_t n;
+    memmove(file -> raw, file -> raw + file -> raw_pos, file -> raw_len - file -> raw_pos);
+    file -> raw_len -= file -> raw_pos;
+    file -> raw_pos = 0;
+    while (!file -> eof && file -> raw_len < file -> raw_size)
+    {
+        if ((n = read(file -> fd, file -> raw + file -> raw_len, file -> raw_size - file -> raw_len)) <= 0)
+            file -> eof = 1;
+        else
+            file -> raw_len += n;
+    }
+    return file -> raw_len;
+}
+
+/******************************************************************************/
+/* Open_reader: open a plain, gzip or BGZF input file, '-' for the standard input */
+static Reader *Open_reader(Biodiff *bd, const char *file_name)
+{
+    Reader *file;
+    struct stat st;
+    unsigned char *h;
+    int fd = strcmp(file_name, "-") ? open(file_name, O_RDONLY) : 0;
+    if (fd < 0)
+        return NULL;
+    file = (Reader *) Take_zero(&bd -> stat, BIODIFF_MEM_IO, 1, sizeof(Reader));
+    file -> fd = fd;
+    file -> bd = bd;
+    if (!fstat(fd, &st) && S_ISREG(st.st_mode))
+    {
+        file -> seekable = 1;
+        file -> size = st.st_size;
+    }
+    file -> raw_size = BGZF_BATCH * BGZF_BLOCK;   /* room for a whole batch of BGZF blocks */
+    file -> raw = (unsigned char *) Take(&bd -> stat, BIODIFF_MEM_IO, file -> raw_size);
+    Raw_fill(file);
+    h = file -> raw;
+    if (file -> raw_len >= 18 && h[0] == 31 && h[1] == 139 && h[2] == 8)
+    {
+        /* BGZF keeps the compressed size of each block in a 'BC' extra subfield */
+        if ((h[3] & 4) && h[12] == 'B' && h[13] == 'C' && h[14] == 2 && h[15] == 0)
+            file -> format = FORMAT_BGZF;
+        else
+            file -> format = FORMAT_GZIP;
+    }
+    file -> buf_size = file -> format == FORMAT_BGZF ? BGZF_BATCH * BGZF_BLOCK : READ_CHUNK;
+    file -> buf = (unsigned char *) Take(&bd -> stat, BIODIFF_MEM_IO, file -> buf_size);
+    if (file -> format == FORMAT_GZIP && inflateInit2(&file -> zs, 16 + MAX_WBITS) != Z_OK)
+        file -> error = 1;
+    return file;
+}
+
+/* a BGZF block and where its decompressed bytes go */
+struct Block
+{
+    unsigned char *in;
+    size_t in_len;
+    unsigned char *out;
+    size_t out_len;
+    uint32_t crc;
+    int error;
+};
+
+/* Inflate_block: decompress one BGZF block, run on the pool */
+static void Inflate_block(void *arg, int i)
+{
+    struct Block *block = (struct Block *) arg + i;
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    block -> error = inflateInit2(&zs, -MAX_WBITS) != Z_OK;
+    if (block -> error)
+        return;
+    zs.next_in = block -> in;
+    zs.avail_in = block -> in_len;
+    zs.next_out = block -> out;
+    zs.avail_out = BGZF_BLOCK;
+    block -> error = inflate(&zs, Z_FINISH) != Z_STREAM_END;
+    block -> out_len = zs.total_out;
+    if (crc32(0, block -> out, block -> out_len) != block -> crc)
+        block -> error = 1;
+    inflateEnd(&zs);
+}
+
+/* Decode_bgzf: decompress the next batch of BGZF blocks in parallel */
+static size_t Decode_bgzf(Reader *file)
+{
+    struct Block block[BGZF_BATCH];
+    unsigned char *h;
+    size_t avail, bsize, used = 0, xlen, x;
+    int n, i;
+    while (!used)
+    {
+        Raw_fill(file);
+        for (n = 0; n < BGZF_BATCH; n++)
+        {
+            h = file -> raw + file -> raw_pos;
+            avail = file -> raw_len - file -> raw_pos;
+            if (avail < 18)
+                break;
+            if (h[0] != 31 || h[1] != 139 || !(h[3] & 4))
+            {
+                file -> error = 1;
+                return 0;
+            }
+            xlen = h[10] | h[11] << 8;
+            for (bsize = 0, x = 12; x + 4 <= 12 + xlen; x += 4 + (h[x + 2] | h[x + 3] << 8))
+                if (h[x] == 'B' && h[x + 1] == 'C')
+                    bsize = (h[x + 4] | h[x + 5] << 8) + 1;
+            if (!bsize || bsize < 12 + xlen + 8)
+            {
+                file -> error = 1;
+                return 0;
+            }
+            if (avail < bsize)
+                break;     /* the rest of the block comes with the next batch */
+            block[n].in = h + 12 + xlen;
+            block[n].in_len = bsize - 12 - xlen - 8;
+            block[n].crc = h[bsize - 8] | h[bsize - 7] << 8 | h[bsize - 6] << 16 | (uint32_t) h[bsize - 5] << 24;
+            block[n].out = file -> buf + (size_t) n * BGZF_BLOCK;
+            file -> raw_pos += bsize;
+            file -> in += bsize;
+        }
+        if (!n)
+        {
+            if (file -> raw_len > file -> raw_pos)
+                file -> error = 1;   /* a truncated block */
+            return 0;
+        }
+        Pool_for(file -> bd -> workers, Inflate_block, block, n);
+        for (i = 0; i < n; i++)    /* join the blocks, they are decompressed at fixed strides */
+        {
+            if (block[i].error)
+            {
+                file -> error = 1;
+                return 0;
+            }
+            memmove(file -> buf + used, block[i].out, block[i].out_len);
+            used += block[i].out_len;
+        }
+    }
+    return used;
+}
+
+/* Decode: decode the next bytes of the file into buf */
+static size_t Decode(Reader *file)
+{
+    size_t used = 0;
+    ssize_t n;
+    int ret;
+    if (file -> error)
+        return 0;      /* a broken file reads as ended */
+    switch (file -> format)
+    {
+        case FORMAT_BGZF:
+            used = Decode_bgzf(file);
+            break;
+        case FORMAT_GZIP:
+            file -> zs.next_out = file -> buf;
+            file -> zs.avail_out = file -> buf_size;
+            while (file -> zs.avail_out)
+            {
+                if (file -> raw_pos == file -> raw_len && !Raw_fill(file))
+                {
+                    if (file -> zs.total_in)
+                        file -> error = 1;   /* the input ends within a member */
+                    break;
+                }
+                file -> zs.next_in = file -> raw + file -> raw_pos;
+                file -> zs.avail_in = file -> raw_len - file -> raw_pos;
+                ret = inflate(&file -> zs, Z_NO_FLUSH);
+                file -> in += file -> raw_len - file -> raw_pos - file -> zs.avail_in;
+                file -> raw_pos = file -> raw_len - file -> zs.avail_in;
+                if (ret == Z_STREAM_END)
+                    inflateReset(&file -> zs);   /* concatenated gzip members */
+                else if (ret != Z_OK && ret != Z_BUF_ERROR)
+                {
+                    file -> error = 1;
+                    break;
+                }
+            }
+            used = file -> buf_size - file -> zs.avail_out;
+            break;
+        default:
+            if (file -> raw_pos < file -> raw_len)   /* the bytes read to detect the format */
+            {
+                used = file -> raw_len - file -> raw_pos;
+                if (used > file -> buf_size)
+                    used = file -> buf_size;
+                memcpy(file -> buf, file -> raw + file -> raw_pos, used);
+                file -> raw_pos += used;
+            }
+            else if (!file -> eof && (n = read(file -> fd, file -> buf, file -> buf_size)) > 0)
+                used = n;
+            else
+                file -> eof = 1;
+            file -> in += used;
+    }
+    file -> out += used;
+    return used;
+}
+
+/* Fill: make the next decoded bytes ready, a pipe replays its spool first */
+static size_t Fill(Reader *file)
+{
+    size_t n;
+    file -> pos = 0;
+    if (!file -> seekable && file -> spool_pos < file -> spool_len)
+    {
+        file -> data = file -> spool + file -> spool_pos;
+        file -> len = file -> spool_len - file -> spool_pos;
+        file -> spool_pos = file -> spool_len;
+        return file -> len;
+    }
+    file -> data = file -> buf;
+    file -> len = n = Decode(file);
+    if (n && !file -> seekable)   /* keep the bytes of a pipe for the next pass */
+    {
+        if (file -> spool_len + n > file -> spool_size)
+        {
+            size_t size = file -> spool_size;
+            while (file -> spool_len + n > file -> spool_size)
+                file -> spool_size = file -> spool_size ? file -> spool_size * 2 : READ_CHUNK;
+            file -> spool = (unsigned char *) Retake(&file -> bd -> stat, BIODIFF_MEM_IO, file -> spool, size, file -> spool_size);
+        }
+        memcpy(file -> spool + file -> spool_len, file -> buf, n);
+        file -> spool_pos = file -> spool_len += n;
+    }
+    return n;
+}
+
+/******************************************************************************/
+/* Read_line: read a line like fgets */
+static char *Read_line(char *line, int size, Reader *file)
+{
+    int n = 0;
+    size_t k;
+    unsigned char *end;
+    while (n < size - 1)
+    {
+        if (file -> pos == file -> len && !Fill(file))
+            break;
+        k = file -> len - file -> pos;
+        if (k > (size_t) (size - 1 - n))
+            k = size - 1 - n;
+        if ((end = memchr(file -> data + file -> pos, '\n', k)))
+            k = end - (file -> data + file -> pos) + 1;
+        memcpy(line + n, file -> data + file -> pos, k);
+        n += k;
+        file -> pos += k;
+        if (end)
+            break;
+    }
+    if (!n)
+        return NULL;
+    line[n] = 0;
+    return line;
+}
+
+/******************************************************************************/
+/* Read_rewind: move back to the start of the file */
+static void Read_rewind(Reader *file)
+{
+    file -> pos = file -> len = 0;
+    if (!file -> seekable)
+    {
+        file -> spool_pos = 0;    /* the spool holds everything read so far */
+        return;
+    }
+    lseek(file -> fd, 0, SEEK_SET);
+    file -> raw_len = file -> raw_pos = 0;
+    file -> eof = 0;
+    if (file -> format == FORMAT_GZIP)
+        inflateReset(&file -> zs);
+}
+
+/******************************************************************************/
+/* Read_empty: whether nothing is left to read */
+static int Read_empty(Reader *file)
+{
+    return file -> pos == file -> len && !Fill(file);
+}
+
+/******************************************************************************/
+/* Close_reader: close the file and release the reader */
+static void Close_reader(Reader *file)
+{
+    if (file -> format == FORMAT_GZIP)
+        inflateEnd(&file -> zs);
+    if (file -> fd)
+        close(file -> fd);
+    Give(&file -> bd -> stat, BIODIFF_MEM_IO, file -> raw, file -> raw_size);
+    Give(&file -> bd -> stat, BIODIFF_MEM_IO, file -> buf, file -> buf_size);
+    Give(&file -> bd -> stat, BIODIFF_MEM_IO, file -> spool, file -> spool_size);
+    Give(&file -> bd -> stat, BIODIFF_MEM_IO, file, sizeof(Reader));
+}
+
+/******************************************************************************/
+/* Map_columns: map a columnar file, *columns is NULL when the file is not one.
+   Every offset read from it is checked to stay inside its section, in O(rows), and
+   the text is mapped from the source when it is there and unchanged. */
+static int Map_columns(Biodiff *bd, const char *file_name, struct Columns **columns)
+{
+    struct Columnar_header head;
+    const struct Column_header *column;
+    struct stat st;
+    unsigned char *map, *text = NULL;
+    size_t size;
+    int fd, ok;
+    long i;
+    *columns = NULL;
+    if (!strcmp(file_name, "-") || (fd = open(file_name, O_RDONLY)) < 0)
+        return BIODIFF_OK;   /* Open_reader reports a file that can not be opened */
+    if (pread(fd, &head, sizeof(head), 0) != sizeof(head) || memcmp(head.magic, COLUMNAR_MAGIC, 8) || fstat(fd, &st))
+    {
+        close(fd);
+        return BIODIFF_OK;
+    }
+    size = st.st_size;
+    map = (unsigned char *) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return Fail(bd, "Can not map the columnar file %s.", file_name);
+#define INSIDE(offset, len) ((offset) >= 0 && (size_t) (offset) <= size && (size_t) (len) <= size - (offset))
+    ok = head.rows >= 0 && head.rows <= UINT32_MAX && head.cols >= 0 && head.cols <= LINE_BUFFER && head.text_size >= 0 &&
+         INSIDE(head.line, head.rows * sizeof(int64_t)) && INSIDE(head.column, head.cols * sizeof(struct Column_header)) &&
+         (head.source ? INSIDE(head.source, 1) && memchr(map + head.source, 0, size - head.source) : INSIDE(head.text, head.text_size));
+    for (i = 0; ok && i < head.rows; i++)
+        ok = ((const int64_t *) (map + head.line))[i] >= 0 && ((const int64_t *) (map + head.line))[i] < head.text_size;
+    for (i = 0; ok && i < head.cols; i++)
+    {
+        column = (const struct Column_header *) (map + head.column) + i;
+        ok = column -> words >= 0 && column -> words <= head.rows + 1 &&
+             INSIDE(column -> dict, (column -> words + 1) * sizeof(int64_t)) &&
+             INSIDE(column -> strings, ((const int64_t *) (map + column -> dict))[column -> words]) &&
+             INSIDE(column -> id, head.rows * sizeof(uint32_t)) &&
+             (!column -> order || (INSIDE(column -> order, head.rows * sizeof(uint32_t)) && INSIDE(column -> delta, 0))) &&
+             Check_column(map, column, head.rows);
+    }
+#undef INSIDE
+    if (!ok)
+    {
+        munmap(map, size);
+        return Fail(bd, "The columnar file %s is damaged.", file_name);
+    }
+    if (head.source)   /* the text is the source, as long as it has not changed */
+    {
+        fd = open((const char *) map + head.source, O_RDONLY);
+        ok = fd >= 0 && !fstat(fd, &st) && st.st_size == head.text_size &&
+             st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec == head.source_mtime;
+        if (ok && head.text_size && (text = (unsigned char *) mmap(NULL, head.text_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+            ok = 0;
+        if (fd >= 0)
+            close(fd);
+        if (!ok)
+        {
+            Fail(bd, "The source %s of the columnar file %s has changed, convert it again.", (const char *) map + head.source, file_name);
+            munmap(map, size);
+            return BIODIFF_ERROR;
+        }
+    }
+    *columns = (struct Columns *) calloc(1, sizeof(struct Columns));
+    (*columns) -> map = map;
+    (*columns) -> size = size;
+    (*columns) -> head = (const struct Columnar_header *) map;
+    (*columns) -> column = (const struct Column_header *) (map + head.column);
+    (*columns) -> text = (const char *) (text ? text : map + head.text);
+    (*columns) -> source = text;
+    (*columns) -> number = (int64_t **) calloc(head.cols + 1, sizeof(int64_t *));
+    (*columns) -> stat = &bd -> stat;
+    return BIODIFF_OK;
+}
+
+/******************************************************************************/
+/* Check_column: whether the strings of the dictionary of a column follow each other, each ended
+   by 0 and shorter than a line, and its ranks and order stay within the words and the rows */
+static int Check_column(const unsigned char *map, const struct Column_header *column, int64_t rows)
+{
+    const int64_t *dict = (const int64_t *) (map + column -> dict);
+    const uint32_t *id = (const uint32_t *) (map + column -> id), *order = (const uint32_t *) (map + column -> order);
+    const char *strings = (const char *) map + column -> strings;
+    int64_t i;
+    if (dict[0])
+        return 0;
+    for (i = 0; i < column -> words; i++)
+        if (dict[i + 1] <= dict[i] || dict[i + 1] - dict[i] > LINE_BUFFER || strings[dict[i + 1] - 1])
+            return 0;
+    for (i = 0; i < rows; i++)
+        if (id[i] >= column -> words || (column -> order && order[i] >= rows))
+            return 0;
+    return 1;
+}
+
+/******************************************************************************/
+/* Unmap_columns: unmap a columnar file and release its decoded numbers */
+static void Unmap_columns(struct Columns *columns)
+{
+    for (long i = 0; i < columns -> head -> cols; i++)
+        Give(columns -> stat, BIODIFF_MEM_ARRAYS, columns -> number[i], sizeof(int64_t) * (columns -> head -> rows + 1));
+    free(columns -> number);
+    if (columns -> source)
+        munmap(columns -> source, columns -> head -> text_size);
+    munmap(columns -> map, columns -> size);
+    free(columns);
+}
+
+/******************************************************************************/
+/* Column_value: the value of column c of a row of a columnar file, "" past the last column
+   as Get_col leaves it */
+static char *Column_value(struct Columns *columns, int c, long row)
+{
+    const struct Column_header *column = columns -> column + c - 1;
+    if (c < 1 || c > columns -> head -> cols)
+        return (char *) "";
+    return (char *) columns -> map + column -> strings +
+           ((const int64_t *) (columns -> map + column -> dict))[((const uint32_t *) (columns -> map + column -> id))[row]];
+}
+
+/******************************************************************************/
+/* Column_numbers: the value of column c of every row as a number, decoded once.
+   A column of integers is decoded from its sorted deltas, any other one is read
+   with atoi once for every distinct value. NULL past the last column. */
+static int64_t *Column_numbers(struct Columns *columns, int c)
+{
+    const struct Column_header *column = columns -> column + c - 1;
+    const unsigned char *p, *end = columns -> map + columns -> size;
+    const uint32_t *order, *id;
+    const int64_t *dict;
+    int64_t *number, *word, v = 0;
+    uint64_t u;
+    long i, rows = columns -> head -> rows;
+    int shift;
+    if (c < 1 || c > columns -> head -> cols)
+        return NULL;
+    if (columns -> number[c - 1])
+        return columns -> number[c - 1];
+    number = (int64_t *) Take(columns -> stat, BIODIFF_MEM_ARRAYS, sizeof(int64_t) * (rows + 1));
+    if (column -> order)
+    {
+        order = (const uint32_t *) (columns -> map + column -> order);
+        p = columns -> map + column -> delta;
+        for (i = 0; i < rows; i++)
+        {
+            for (u = 0, shift = 0; p < end && *p & 128 && shift < 63; shift += 7)
+                u |= (uint64_t) (*p++ & 127) << shift;
+            if (p < end)
+                u |= (uint64_t) *p++ << shift;
+            v += (int64_t) (u >> 1) ^ -(int64_t) (u & 1);   /* zigzag */
+            number[order[i]] = v;
+        }
+    }
+    else
+    {
+        dict = (const int64_t *) (columns -> map + column -> dict);
+        id = (const uint32_t *) (columns -> map + column -> id);
+        word = (int64_t *) Take(columns -> stat, BIODIFF_MEM_ARRAYS, sizeof(int64_t) * (column -> words + 1));
+        for (i = 0; i < column -> words; i++)
+            word[i] = atoi((const char *) columns -> map + column -> strings + dict[i]);
+        for (i = 0; i < rows; i++)
+            number[i] = word[id[i]];
+        Give(columns -> stat, BIODIFF_MEM_ARRAYS, word, sizeof(int64_t) * (column -> words + 1));
+    }
+    return columns -> number[c - 1] = number;
+}
+
+/* a value of a column while it is converted */
+struct Word
+{
+    const char *str;
+    int64_t number;
+    uint32_t row;
+};
+
+/* Cmp_word: order values as strcmp does, then by row */
+static int Cmp_word(const void *a, const void *b)
+{
+    const struct Word *x = (const struct Word *) a, *y = (const struct Word *) b;
+    int c = strcmp(x -> str, y -> str);
+    return c ? c : x -> row < y -> row ? -1 : x -> row > y -> row;
+}
+
+/* Cmp_number: order values as numbers, then by row */
+static int Cmp_number(const void *a, const void *b)
+{
+    const struct Word *x = (const struct Word *) a, *y = (const struct Word *) b;
+    if (x -> number != y -> number)
+        return x -> number < y -> number ? -1 : 1;
+    return x -> row < y -> row ? -1 : x -> row > y -> row;
+}
+
+/* Is_number: whether a value is an integer that atoi reads back exactly: no '+',
+   no leading zero, no "-0" and no overflow of an int */
+static int Is_number(const char *str)
+{
+    const char *p = str + (*str == '-');
+    long long n = 0;
+    if (*p == '0')
+        return !p[1] && p == str;
+    if (!*p)
+        return 0;
+    for (; *p; p++)
+        if (*p < '0' || *p > '9' || (n = n * 10 + *p - '0') > 2147483647LL + (*str == '-'))
+            return 0;
+    return 1;
+}
+
+/* Put_section: append a section to a columnar file, padded to 8 bytes, and return its offset */
+static int64_t Put_section(FILE *out, const void *data, size_t len)
+{
+    static const char pad[8];
+    int64_t offset = ftello(out);
+    fwrite(data, 1, len, out);
+    fwrite(pad, 1, -len & 7, out);
+    return offset;
+}
+
+/* Put_column: sort the values of a column into its dictionary, and its numbers when
+   every value is an integer, and append them to a columnar file */
+static void Put_column(FILE *out, struct Column_header *column, const char *text, size_t bytes, const int64_t *at, long rows)
+{
+    struct Word *word = (struct Word *) malloc(sizeof(struct Word) * (rows + 1));
+    int64_t *dict = (int64_t *) malloc(sizeof(int64_t) * (rows + 1)), v = 0;
+    uint32_t *id = (uint32_t *) malloc(sizeof(uint32_t) * (rows + 1));
+    unsigned char *delta, *p;
+    char *strings;
+    size_t used = 0;
+    uint64_t u;
+    long i, n = 0;
+    int number = 1;
+    for (i = 0; i < rows; i++)
+    {
+        word[i].str = text + at[i];
+        word[i].row = i;
+    }
+    qsort(word, rows, sizeof(struct Word), Cmp_word);
+    strings = (char *) malloc(bytes);   /* every value at most once */
+    for (i = 0; i < rows; i++)
+    {
+        if (!i || strcmp(word[i].str, word[i - 1].str))
+        {
+            dict[n++] = used;
+            strcpy(strings + used, word[i].str);
+            used += strlen(word[i].str) + 1;
+            number = number && Is_number(word[i].str);
+        }
+        id[word[i].row] = n - 1;
+        word[i].number = atoi(word[i].str);
+    }
+    dict[n] = used;
+    column -> words = n;
+    column -> dict = Put_section(out, dict, sizeof(int64_t) * (n + 1));
+    column -> strings = Put_section(out, strings, used);
+    column -> id = Put_section(out, id, sizeof(uint32_t) * rows);
+    column -> order = column -> delta = 0;
+    if (number && rows)
+    {
+        qsort(word, rows, sizeof(struct Word), Cmp_number);
+        p = delta = (unsigned char *) malloc(rows * 10);
+        for (i = 0; i < rows; i++)
+        {
+            id[i] = word[i].row;
+            u = (uint64_t) (word[i].number - v) << 1 ^ -(uint64_t) (word[i].number < v);   /* zigzag */
+            v = word[i].number;
+            for (; u >= 128; u >>= 7)
+                *p++ = (u & 127) | 128;
+            *p++ = u;
+        }
+        column -> order = Put_section(out, id, sizeof(uint32_t) * rows);
+        column -> delta = Put_section(out, delta, p - delta);
+        free(delta);
+    }
+    free(word);
+    free(dict);
+    free(id);
+    free(strings);
+}
+
+/* Plain_source: whether a file holds exactly the bytes of a buffer, as a plain file holds its
+   decoded text, and its mtime in ns */
+static int Plain_source(const char *file_name, const char *data, size_t len, int64_t *mtime)
+{
+    struct stat st;
+    void *map = NULL;
+    int fd, same;
+    if (!strcmp(file_name, "-") || (fd = open(file_name, O_RDONLY)) < 0)
+        return 0;
+    same = !fstat(fd, &st) && S_ISREG(st.st_mode) && (size_t) st.st_size == len;
+    if (same && len && ((map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED || memcmp(map, data, len)))
+        same = 0;
+    if (map && map != MAP_FAILED)
+        munmap(map, len);
+    close(fd);
+    if (same)
+        *mtime = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    return same;
+}
+
+/******************************************************************************/
+/* Biodiff_convert: convert a plain, gzip or BGZF file into a columnar file.
+   Every column is cut as Get_col cuts it; the records are those of Biodiff_table_buffer.
+   A plain file is referred to by its path, the text of any other one is kept in the file. */
+int Biodiff_convert(Biodiff *bd, const char *source, const char *target)
+{
+    struct Columnar_header head;
+    struct Column_header *column;
+    struct Cursor cursor;
+    Biodiff_table *table;
+    FILE *out;
+    char *data, **text = NULL, *path = NULL, value[LINE_BUFFER];
+    int64_t **at = NULL;
+    size_t len, *used = NULL, *size = NULL, n;
+    long row, cols = 0, c, count;
+    int none[2] = {0, 0}, status = BIODIFF_OK;
+    if (!(data = Biodiff_load(bd, source, &len)))
+        return BIODIFF_ERROR;
+    if (!(table = Biodiff_table_buffer(bd, data, len, none)))
+    {
+        free(data);
+        return BIODIFF_ERROR;
+    }
+    if (table -> rows > UINT32_MAX)
+    {
+        Biodiff_table_free(table);
+        free(data);
+        return Fail(bd, "Too many rows in %s for a columnar file.", source);
+    }
+    /* cut every row into its columns, each column kept apart */
+    Open_rows(bd, table, &cursor);
+    for (row = 0; Next_row(&cursor); row++)
+    {
+        for (count = 1, n = strspn(cursor.line, "\t"); cursor.line[n]; n++)
+            if (cursor.line[n] == SEPARATORS && cursor.line[n + 1] != SEPARATORS)
+                count++;   /* a run of separators ends a column */
+        if (count > cols)
+        {
+            text = (char **) realloc(text, sizeof(char *) * count);
+            at = (int64_t **) realloc(at, sizeof(int64_t *) * count);
+            used = (size_t *) realloc(used, sizeof(size_t) * count);
+            size = (size_t *) realloc(size, sizeof(size_t) * count);
+            for (; cols < count; cols++)
+            {
+                /* earlier rows have an empty value at offset 0 */
+                at[cols] = (int64_t *) calloc(table -> rows + 1, sizeof(int64_t));
+                text[cols] = (char *) calloc(size[cols] = READ_CHUNK, 1);
+                used[cols] = 1;
+            }
+        }
+        for (c = 0; c < count; c++)
+        {
+            *value = 0;
+            Get_col(cursor.line, value, SEPARATORS, c + 1);
+            n = strlen(value) + 1;
+            if (used[c] + n > size[c])
+            {
+                while (used[c] + n > size[c])
+                    size[c] *= 2;
+                text[c] = (char *) realloc(text[c], size[c]);
+            }
+            memcpy(text[c] + used[c], value, n);
+            at[c][row] = used[c];
+            used[c] += n;
+        }
+    }
+    Close_rows(bd, &cursor);
+
+    /* the text and its lines first, the header last once every offset is known */
+    if (!(out = fopen(target, "wb")))
+        status = Fail(bd, "Can not create the output file %s.", target);
+    else
+    {
+        memset(&head, 0, sizeof(head));
+        Put_section(out, &head, sizeof(head));
+        head.rows = table -> rows;
+        head.cols = cols;
+        head.text_size = len;
+        if (Plain_source(source, data, len, &head.source_mtime) && (path = realpath(source, NULL)))
+            head.source = Put_section(out, path, strlen(path) + 1);   /* only the offsets into it are kept */
+        else
+            head.text = Put_section(out, data, len);
+        free(path);
+        head.line = Put_section(out, table -> offset, sizeof(int64_t) * table -> rows);
+        column = (struct Column_header *) calloc(cols + 1, sizeof(struct Column_header));
+        for (c = 0; c < cols; c++)
+            Put_column(out, column + c, text[c], used[c], at[c], table -> rows);
+        head.column = Put_section(out, column, sizeof(struct Column_header) * cols);
+        memcpy(head.magic, COLUMNAR_MAGIC, 8);
+        fseeko(out, 0, SEEK_SET);
+        fwrite(&head, sizeof(head), 1, out);
+        if (ferror(out) | fclose(out))
+            status = Fail(bd, "Can not write the output file %s.", target);
+        free(column);
+    }
+    for (c = 0; c < cols; c++)
+    {
+        free(text[c]);
+        free(at[c]);
+    }
+    free(text);
+    free(at);
+    free(used);
+    free(size);
+    Biodiff_table_free(table);
+    free(data);
+    return status;
+}
+
+/******************************************************************************/
+/* Region_span: the half-open span of the bins of two coordinates, both ends included.
+   The coordinates are clamped to what the bins tell apart; the records are compared
+   with their own numbers afterwards. */
+static void Region_span(long left, long right, int *begin, int *end)
+{
+    *begin = left < 0 ? 0 : left > REGION_LIMIT ? REGION_LIMIT : left;
+    *end = right < *begin ? *begin : right > REGION_LIMIT ? REGION_LIMIT : right;
+    ++*end;
+}
+
+/* Region_bin: the smallest bin that holds a span, the bins of UCSC: 512 Mb, then 64 Mb,
+   8 Mb, 1 Mb, 128 kb and 16 kb, each level numbered after the ones above it */
+static int Region_bin(int begin, int end)
+{
+    --end;
+    if (begin >> 14 == end >> 14)
+        return 4681 + (begin >> 14);
+    if (begin >> 17 == end >> 17)
+        return 585 + (begin >> 17);
+    if (begin >> 20 == end >> 20)
+        return 73 + (begin >> 20);
+    if (begin >> 23 == end >> 23)
+        return 9 + (begin >> 23);
+    if (begin >> 26 == end >> 26)
+        return 1 + (begin >> 26);
+    return 0;
+}
+
+/* Region_bins: the bins that may hold a record overlapping a span, the one bin of
+   every level above it and the bins of every level under it */
+static int Region_bins(int begin, int end, int *list)
+{
+    static const int first[6] = {0, 1, 9, 73, 585, 4681}, shift[6] = {29, 26, 23, 20, 17, 14};
+    int n = 0, level, k;
+    --end;
+    for (level = 0; level < 6; level++)
+        for (k = first[level] + (begin >> shift[level]); k <= first[level] + (end >> shift[level]); k++)
+            list[n++] = k;
+    return n;
+}
+
+/* Cmp_chunk: the comparison function for qsort, by bin then by offset */
+static int Cmp_chunk(const void *a, const void *b)
+{
+    const struct Region_chunk *x = (const struct Region_chunk *) a, *y = (const struct Region_chunk *) b;
+    if (x -> bin != y -> bin)
+        return x -> bin < y -> bin ? -1 : 1;
+    return x -> begin < y -> begin ? -1 : x -> begin > y -> begin;
+}
+
+/******************************************************************************/
+/* Biodiff_index: build the binned index of a file, as tabix does: every record goes to
+   the smallest bin that holds it, and the records next to each other in a bin are one
+   chunk of bytes. A linear index of 16 kb windows skips the chunks that end before the
+   first record of a window. The file need not be sorted, sorted files only have fewer chunks. */
+int Biodiff_index(Biodiff *bd, const char *file_name, int sequence, const int *col)
+{
+    struct Region_header head;
+    struct Region_sequence *out_sequence;
+    struct Binning *binning = NULL, *s = NULL;
+    struct Region_chunk *chunk;
+    struct Cursor cursor;
+    struct stat st;
+    Biodiff_table *table;
+    FILE *out;
+    char name[COLUMN_SIZE], start[COLUMN_SIZE], end[COLUMN_SIZE], *index_name;
+    int none[2] = {0, 0}, begin, stop, status = BIODIFF_OK;
+    int64_t bin, *window;
+    long n = 0, i, k, w;
+    if (!strcmp(file_name, "-") || stat(file_name, &st))
+        return Fail(bd, "Can not index %s, it is not a file.", file_name);
+    if (!(table = Biodiff_table_file(bd, file_name, none)))
+        return BIODIFF_ERROR;
+    Open_rows(bd, table, &cursor);
+    while (Next_row(&cursor))
+    {
+        *name = *start = *end = 0;
+        if (sequence)
+            Get_col(cursor.line, name, SEPARATORS, sequence);
+        Get_col(cursor.line, start, SEPARATORS, col[0]);
+        Get_col(cursor.line, end, SEPARATORS, col[1]);
+        if (!s || strcmp(s -> name, name))   /* the rows of a sequence usually come together */
+        {
+            for (i = 0; i < n && strcmp(binning[i].name, name); i++)
+                ;
+            if (i == n)
+            {
+                binning = (struct Binning *) realloc(binning, sizeof(struct Binning) * ++n);
+                memset(binning + i, 0, sizeof(struct Binning));
+                binning[i].name = strdup(name);
+            }
+            s = binning + i;
+        }
+        Region_span(atoi(start), atoi(end), &begin, &stop);
+        bin = Region_bin(begin, stop);
+        chunk = s -> chunks ? s -> chunk + s -> chunks - 1 : NULL;
+        if (chunk && chunk -> bin == bin && chunk -> end == cursor.at)
+            chunk -> end = cursor.at + strlen(cursor.line);   /* the record follows the last one of its bin */
+        else
+        {
+            if (s -> chunks == s -> size)
+            {
+                s -> size = s -> size ? s -> size * 2 : 1024;
+                s -> chunk = (struct Region_chunk *) realloc(s -> chunk, sizeof(struct Region_chunk) * s -> size);
+            }
+            chunk = s -> chunk + s -> chunks++;
+            chunk -> bin = bin;
+            chunk -> begin = cursor.at;
+            chunk -> end = cursor.at + strlen(cursor.line);
+        }
+        if ((stop - 1) >> REGION_SHIFT >= s -> windows)
+        {
+            k = ((stop - 1) >> REGION_SHIFT) + 1;
+            s -> window = (int64_t *) realloc(s -> window, sizeof(int64_t) * k);
+            for (w = s -> windows; w < k; w++)
+                s -> window[w] = INT64_MAX;
+            s -> windows = k;
+        }
+        for (w = begin >> REGION_SHIFT; w <= (stop - 1) >> REGION_SHIFT; w++)
+            if (cursor.at < s -> window[w])
+                s -> window[w] = cursor.at;
+    }
+    if (Close_rows(bd, &cursor))
+        status = BIODIFF_ERROR;
+    Biodiff_table_free(table);
+
+    /* the chunks of a bin in order, joined where they touch; a window holds the first
+       record of any later window too, so the linear index holds for unsorted files */
+    for (i = 0; i < n; i++)
+    {
+        s = binning + i;
+        qsort(s -> chunk, s -> chunks, sizeof(struct Region_chunk), Cmp_chunk);
+        for (k = 0, w = 1; w < s -> chunks; w++)
+            if (s -> chunk[w].bin == s -> chunk[k].bin && s -> chunk[w].begin == s -> chunk[k].end)
+                s -> chunk[k].end = s -> chunk[w].end;
+            else
+                s -> chunk[++k] = s -> chunk[w];
+        s -> chunks = s -> chunks ? k + 1 : 0;
+        for (window = s -> window, w = s -> windows - 2; w >= 0; w--)
+            if (window[w + 1] < window[w])
+                window[w] = window[w + 1];
+    }
+
+    index_name = (char *) malloc(strlen(file_name) + sizeof(REGION_SUFFIX));
+    strcat(strcpy(index_name, file_name), REGION_SUFFIX);
+    if (!status && !(out = fopen(index_name, "wb")))
+        status = Fail(bd, "Can not create the output file %s.", index_name);
+    else if (!status)
+    {
+        memset(&head, 0, sizeof(head));
+        Put_section(out, &head, sizeof(head));
+        out_sequence = (struct Region_sequence *) calloc(n + 1, sizeof(struct Region_sequence));
+        for (i = 0; i < n; i++)
+        {
+            out_sequence[i].name = Put_section(out, binning[i].name, strlen(binning[i].name) + 1);
+            out_sequence[i].chunks = binning[i].chunks;
+            out_sequence[i].chunk = Put_section(out, binning[i].chunk, sizeof(struct Region_chunk) * binning[i].chunks);
+            out_sequence[i].windows = binning[i].windows;
+            out_sequence[i].window = Put_section(out, binning[i].window, sizeof(int64_t) * binning[i].windows);
+        }
+        head.col[0] = sequence;
+        head.col[1] = col[0];
+        head.col[2] = col[1];
+        head.size = st.st_size;
+        head.mtime = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+        head.sequences = n;
+        head.sequence = Put_section(out, out_sequence, sizeof(struct Region_sequence) * n);
+        memcpy(head.magic, REGION_MAGIC, 8);
+        fseeko(out, 0, SEEK_SET);
+        fwrite(&head, sizeof(head), 1, out);
+        if (ferror(out) | fclose(out))
+            status = Fail(bd, "Can not write the output file %s.", index_name);
+        free(out_sequence);
+    }
+    for (i = 0; i < n; i++)
+    {
+        free(binning[i].name);
+        free(binning[i].chunk);
+        free(binning[i].window);
+    }
+    free(binning);
+    free(index_name);
+    return status;
+}
+
+/******************************************************************************/
+/* Map_regions: map the binned index of a file and check that it is up to date.
+   The bounds of every section are checked, and every chunk is checked to lie within the file;
+   the rest of the contents are trusted as Biodiff_index wrote them. */
+static int Map_regions(Biodiff *bd, const char *file_name, struct Regions **regions)
+{
+    struct Region_header head;
+    const struct Region_sequence *sequence;
+    const struct Region_chunk *chunk;
+    struct stat st, source;
+    unsigned char *map;
+    char *index_name = (char *) malloc(strlen(file_name) + sizeof(REGION_SUFFIX));
+    size_t size;
+    int fd, ok;
+    long i, k;
+    *regions = NULL;
+    strcat(strcpy(index_name, file_name), REGION_SUFFIX);
+    fd = open(index_name, O_RDONLY);
+    free(index_name);
+    if (stat(file_name, &source))
+        ok = Fail(bd, "Can not open the input file %s.", file_name);
+    else if (fd < 0)
+        ok = Fail(bd, "The file %s has no index, make one with Biodiff_index.", file_name);
+    else if (pread(fd, &head, sizeof(head), 0) != sizeof(head) || memcmp(head.magic, REGION_MAGIC, 8) || fstat(fd, &st))
+        ok = Fail(bd, "The index of %s is damaged.", file_name);
+    else if (head.size != source.st_size || head.mtime != source.st_mtim.tv_sec * 1000000000LL + source.st_mtim.tv_nsec)
+        ok = Fail(bd, "The index of %s is older than the file, make it again.", file_name);
+    else
+        ok = BIODIFF_OK;
+    if (ok)
+    {
+        if (fd >= 0)
+            close(fd);
+        return BIODIFF_ERROR;
+    }
+    size = st.st_size;
+    map = (unsigned char *) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return Fail(bd, "Can not map the index of %s.", file_name);
+#define INSIDE(offset, len) ((offset) >= 0 && (size_t) (offset) <= size && (size_t) (len) <= size - (offset))
+    ok = head.sequences >= 0 && head.sequences <= INT32_MAX &&
+         INSIDE(head.sequence, head.sequences * sizeof(struct Region_sequence));
+    for (i = 0; ok && i < head.sequences; i++)
+    {
+        sequence = (const struct Region_sequence *) (map + head.sequence) + i;
+        ok = INSIDE(sequence -> name, 1) && memchr(map + sequence -> name, 0, size - sequence -> name) &&
+             sequence -> chunks >= 0 && sequence -> chunks <= INT32_MAX &&
+             INSIDE(sequence -> chunk, sequence -> chunks * sizeof(struct Region_chunk)) &&
+             sequence -> windows >= 0 && sequence -> windows <= (REGION_LIMIT >> REGION_SHIFT) + 1 &&
+             INSIDE(sequence -> window, sequence -> windows * sizeof(int64_t));
+        chunk = (const struct Region_chunk *) (map + (ok ? sequence -> chunk : 0));
+        for (k = 0; ok && k < sequence -> chunks; k++)   /* Read_chunks reads end - begin bytes at begin */
+            ok = chunk[k].begin >= 0 && chunk[k].begin <= chunk[k].end && chunk[k].end <= head.size;
+    }
+#undef INSIDE
+    if (!ok)
+    {
+        munmap(map, size);
+        return Fail(bd, "The index of %s is damaged.", file_name);
+    }
+    *regions = (struct Regions *) calloc(1, sizeof(struct Regions));
+    (*regions) -> map = map;
+    (*regions) -> size = size;
+    (*regions) -> head = (const struct Region_header *) map;
+    (*regions) -> sequence = (const struct Region_sequence *) (map + head.sequence);
+    return BIODIFF_OK;
+}
+
+/******************************************************************************/
+/* Read_chunks: the records of a file in the chunks, sorted and apart, one after another.
+   A plain file is read at their offsets, a columnar file copied from its text. */
+static char *Read_chunks(Biodiff *bd, const char *file_name, struct Region_chunk *chunk, long chunks, size_t *len)
+{
+    struct Columns *columns;
+    unsigned char magic[2] = {0, 0};
+    char *data;
+    long i;
+    int fd;
+    if (Map_columns(bd, file_name, &columns))
+        return NULL;
+    for (*len = i = 0; i < chunks; i++)
+        *len += chunk[i].end - chunk[i].begin;
+    if (!(data = (char *) malloc(*len + 1)))
+    {
+        if (columns)
+            Unmap_columns(columns);
+        Fail(bd, "Can not take %zu bytes for the regions of %s.", *len + 1, file_name);
+        return NULL;
+    }
+    if (columns)
+    {
+        for (*len = i = 0; i < chunks; *len += chunk[i].end - chunk[i].begin, i++)
+            if (chunk[i].end <= columns -> head -> text_size)
+                memcpy(data + *len, columns -> text + chunk[i].begin, chunk[i].end - chunk[i].begin);
+            else
+                break;
+        Unmap_columns(columns);
+    }
+    else if ((fd = open(file_name, O_RDONLY)) < 0)
+        i = -1;
+    else
+    {
+        if (pread(fd, magic, 2, 0) == 2 && magic[0] == 31 && magic[1] == 139)
+            i = -2;   /* a compressed file is only read from its start */
+        else
+            for (*len = i = 0; i < chunks; *len += chunk[i].end - chunk[i].begin, i++)
+                if (pread(fd, data + *len, chunk[i].end - chunk[i].begin, chunk[i].begin) != chunk[i].end - chunk[i].begin)
+                    break;
+        close(fd);
+    }
+    if (i == chunks)
+        return data;
+    free(data);
+    if (i == -1)
+        Fail(bd, "Can not open the input file %s.", file_name);
+    else if (i == -2)
+        Fail(bd, "Can not read the regions of %s, it is compressed; index a plain or columnar file.", file_name);
+    else
+        Fail(bd, "The file %s is shorter than its index says.", file_name);
+    return NULL;
+}
+
+/******************************************************************************/
+/* Biodiff_table_region: a table of only the records of a file that overlap one of the
+   regions. The chunks of the bins the regions touch are read, as much as the linear index
+   leaves of them, and every record in them is compared with the regions. */
+Biodiff_table *Biodiff_table_region(Biodiff *bd, const char *file_name, const int *col, const Biodiff_region *region, int n)
+{
+    struct Regions *regions;
+    const struct Region_sequence *s;
+    const struct Region_chunk *entry;
+    struct Region_chunk *chunk = NULL;
+    Biodiff_table *table;
+    const int32_t *index_col;
+    char *data, line[LINE_BUFFER], name[COLUMN_SIZE], start[COLUMN_SIZE], end[COLUMN_SIZE];
+    int *list, bins, begin, stop, r, b;
+    long i, lo, hi, chunks = 0, size = 0, left, right, kept = 0;
+    int64_t first;
+    size_t len, pos, k, used;
+    const char *cut;
+    if (Map_regions(bd, file_name, &regions))
+        return NULL;
+    index_col = regions -> head -> col;
+    list = (int *) malloc(sizeof(int) * REGION_BINS);
+    for (r = 0; r < n; r++)
+    {
+        if (region[r].name && !index_col[0])
+        {
+            Fail(bd, "The index of %s has no sequence column to find %s in.", file_name, region[r].name);
+            break;
+        }
+        Region_span(region[r].start, region[r].end, &begin, &stop);
+        bins = Region_bins(begin, stop, list);
+        for (i = 0; i < regions -> head -> sequences; i++)
+        {
+            s = regions -> sequence + i;
+            if ((region[r].name && strcmp(region[r].name, (const char *) regions -> map + s -> name)) ||
+                begin >> REGION_SHIFT >= s -> windows)
+                continue;   /* another sequence, or none of its records reaches the region */
+            first = ((const int64_t *) (regions -> map + s -> window))[begin >> REGION_SHIFT];
+            entry = (const struct Region_chunk *) (regions -> map + s -> chunk);
+            for (b = 0; b < bins; b++)
+            {
+                for (lo = 0, hi = s -> chunks; lo < hi; )   /* the first chunk of the bin */
+                    if (entry[(lo + hi) / 2].bin < list[b])
+                        lo = (lo + hi) / 2 + 1;
+                    else
+                        hi = (lo + hi) / 2;
+                for (; lo < s -> chunks && entry[lo].bin == list[b]; lo++)
+                    if (entry[lo].end > first)
+                    {
+                        if (chunks == size)
+                        {
+                            size = size ? size * 2 : 64;
+                            chunk = (struct Region_chunk *) realloc(chunk, sizeof(struct Region_chunk) * size);
+                        }
+                        chunk[chunks++] = entry[lo];
+                    }
+            }
+        }
+    }
+    free(list);
+    if (r < n)
+    {
+        free(chunk);
+        munmap(regions -> map, regions -> size);
+        free(regions);
+        return NULL;
+    }
+
+    /* the chunks in the order of the file, each byte once */
+    for (i = 0; i < chunks; i++)
+        chunk[i].bin = 0;
+    qsort(chunk, chunks, sizeof(struct Region_chunk), Cmp_chunk);
+    for (k = 0, i = 1; i < chunks; i++)
+        if (chunk[i].begin <= chunk[k].end)
+            chunk[k].end = chunk[i].end > chunk[k].end ? chunk[i].end : chunk[k].end;
+        else
+            chunk[++k] = chunk[i];
+    chunks = chunks ? (long) k + 1 : 0;
+    data = Read_chunks(bd, file_name, chunk, chunks, &len);
+    free(chunk);
+    if (!data)
+    {
+        munmap(regions -> map, regions -> size);
+        free(regions);
+        return NULL;
+    }
+
+    /* keep the records that overlap a region, cut as Biodiff_table_buffer cuts them */
+    for (pos = used = 0; pos < len; pos += k)
+    {
+        k = len - pos < LINE_BUFFER - 1 ? len - pos : LINE_BUFFER - 1;
+        if ((cut = memchr(data + pos, '\n', k)))
+            k = cut - (data + pos) + 1;
+        memcpy(line, data + pos, k);
+        line[k] = 0;
+        *name = *start = *end = 0;
+        if (index_col[0])
+            Get_col(line, name, SEPARATORS, index_col[0]);
+        Get_col(line, start, SEPARATORS, index_col[1]);
+        Get_col(line, end, SEPARATORS, index_col[2]);
+        left = atoi(start);
+        right = atoi(end);
+        for (r = 0; r < n; r++)
+            if ((!region[r].name || !strcmp(region[r].name, name)) && left <= region[r].end && right >= region[r].start)
+                break;
+        if (r < n && *line != '\n')
+        {
+            memmove(data + used, data + pos, k);
+            used += k;
+            kept++;
+        }
+    }
+    Report(bd, "Regions of %s: %lu bytes read in %ld ranges, %ld records kept", file_name, (unsigned long) len, chunks, kept);
+    munmap(regions -> map, regions -> size);
+    free(regions);
+    data = (char *) realloc(data, used + 1);   /* cut to the records kept */
+    Account(&bd -> stat, BIODIFF_MEM_IO, used + 1, 1);
+    if ((table = Biodiff_table_buffer(bd, data, used, col)))
+        table -> held = data;
+    else
+        Give(&bd -> stat, BIODIFF_MEM_IO, data, used + 1);
+    return table;
+}
+
+/******************************************************************************/
+/* Biodiff_writer_append: open a plain output file to add lines at its end, created when it is missing */
+Biodiff_writer *Biodiff_writer_append(Biodiff *bd, const char *file_name)
+{
+    Writer *file = (Writer *) calloc(1, sizeof(Writer));
+    if (!(file -> file = fopen(file_name, "a")))
+    {
+        free(file);
+        Fail(bd, "Can not open the output file %s.", file_name);
+        return NULL;
+    }
+    file -> bd = bd;
+    setvbuf(file -> file, NULL, _IOFBF, FILE_BUFFER);
+    return file;
+}
+
+/******************************************************************************/
+/* Biodiff_writer_open: create an output file, with the .gz suffix when it is BGZF */
+Biodiff_writer *Biodiff_writer_open(Biodiff *bd, const char *file_name, int bgzf, int gzi)
+{
+    Writer *file = (Writer *) calloc(1, sizeof(Writer));
+    char name[LINE_BUFFER];
+    snprintf(name, LINE_BUFFER, bgzf ? "%s.gz" : "%s", file_name);
+    if (!(file -> file = fopen(name, "w")))
+    {
+        free(file);
+        Fail(bd, "Can not create the output file %s.", name);
+        return NULL;
+    }
+    file -> bd = bd;
+    if (!bgzf)
+    {
+        setvbuf(file -> file, NULL, _IOFBF, FILE_BUFFER);  /* set buffer for the output stream */
+        return file;
+    }
+    file -> bgzf = 1;
+    file -> buf = (unsigned char *) Take(&bd -> stat, BIODIFF_MEM_IO, BGZF_BATCH * BGZF_DATA);
+    file -> out = (unsigned char *) Take(&bd -> stat, BIODIFF_MEM_IO, BGZF_BATCH * BGZF_BLOCK);
+    if (gzi)
+    {
+        file -> gzi = (char *) malloc(strlen(name) + 5);
+        sprintf(file -> gzi, "%s.gzi", name);
+    }
+    return file;
+}
+
+/* a BGZF block to compress: its input bytes and its place in the output */
+struct Deflation
+{
+    unsigned char *in;
+    size_t in_len;
+    unsigned char *out;        /* BGZF_BLOCK bytes for the whole block */
+    size_t out_len;
+};
+
+/* Deflate_block: compress one BGZF block with its header and footer, run on the pool */
+static void Deflate_block(void *arg, int i)
+{
+    struct Deflation *block = (struct Deflation *) arg + i;
+    static const unsigned char header[16] = {31, 139, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0, 'B', 'C', 2, 0};
+    unsigned char *out = block -> out;
+    uint32_t crc = crc32(0, block -> in, block -> in_len);
+    z_stream zs;
+    int level;
+    for (level = Z_DEFAULT_COMPRESSION; ; level = Z_NO_COMPRESSION)
+    {
+        memset(&zs, 0, sizeof(zs));
+        deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        zs.next_in = block -> in;
+        zs.avail_in = block -> in_len;
+        zs.next_out = out + 18;
+        zs.avail_out = BGZF_BLOCK - 18 - 8;
+        if (deflate(&zs, Z_FINISH) == Z_STREAM_END || level == Z_NO_COMPRESSION)
+            break;
+        deflateEnd(&zs);      /* incompressible bytes are stored instead */
+    }
+    block -> out_len = 18 + zs.total_out + 8;
+    deflateEnd(&zs);
+    memcpy(out, header, 16);
+    out[16] = (block -> out_len - 1) & 0xff;
+    out[17] = (block -> out_len - 1) >> 8;
+    out += 18 + zs.total_out;
+    for (i = 0; i < 4; i++)
+    {
+        out[i] = crc >> (8 * i);
+        out[4 + i] = block -> in_len >> (8 * i);
+    }
+}
+
+/* Flush_writer: compress the pending bytes in parallel and write the blocks in order */
+static void Flush_writer(Writer *file)
+{
+    struct Deflation block[BGZF_BATCH];
+    int n, i;
+    for (n = 0; (size_t) n * BGZF_DATA < file -> len; n++)
+    {
+        block[n].in = file -> buf + (size_t) n * BGZF_DATA;
+        block[n].in_len = file -> len - (size_t) n * BGZF_DATA < BGZF_DATA ? file -> len - (size_t) n * BGZF_DATA : BGZF_DATA;
+        block[n].out = file -> out + (size_t) n * BGZF_BLOCK;
+    }
+    Pool_for(file -> bd -> workers, Deflate_block, block, n);
+    for (i = 0; i < n; i++)
+    {
+        if (file -> gzi && file -> coffset)   /* the first block is implied at 0, 0 */
+        {
+            if (file -> entries + 2 > file -> size)
+            {
+                file -> index = (uint64_t *) Retake(&file -> bd -> stat, BIODIFF_MEM_IO, file -> index, sizeof(uint64_t) * file -> size,
+                                                    sizeof(uint64_t) * (file -> size ? file -> size * 2 : 1024));
+                file -> size = file -> size ? file -> size * 2 : 1024;
+            }
+            file -> index[file -> entries++] = file -> coffset;
+            file -> index[file -> entries++] = file -> uoffset;
+        }
+        fwrite(block[i].out, 1, block[i].out_len, file -> file);
+        file -> coffset += block[i].out_len;
+        file -> uoffset += block[i].in_len;
+    }
+    file -> len = 0;
+}
+
+/******************************************************************************/
+/* Biodiff_write: write a line to the output file */
+void Biodiff_write(Biodiff_writer *file, const char *line)
+{
+    size_t n, k;
+    if (!file -> bgzf)
+    {
+        fputs(line, file -> file);
+        return;
+    }
+    for (n = strlen(line); n; n -= k, line += k)
+    {
+        k = BGZF_BATCH * BGZF_DATA - file -> len;
+        if (k > n)
+            k = n;
+        memcpy(file -> buf + file -> len, line, k);
+        if ((file -> len += k) == BGZF_BATCH * BGZF_DATA)
+            Flush_writer(file);
+    }
+}
+
+/******************************************************************************/
+/* Biodiff_writer_close: finish the output file and its index, and release the writer */
+int Biodiff_writer_close(Biodiff_writer *file)
+{
+    /* the empty block bgzip writes as an end-of-file marker */
+    static const unsigned char eof[28] = {31, 139, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0, 'B', 'C', 2, 0,
+                                          27, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    FILE *gzi;
+    uint64_t entries;
+    int status = BIODIFF_OK;
+    if (file -> bgzf)
+    {
+        Flush_writer(file);
+        fwrite(eof, 1, sizeof(eof), file -> file);
+    }
+    fclose(file -> file);
+    if (file -> gzi)
+    {
+        if (!(gzi = fopen(file -> gzi, "w")))
+            status = Fail(file -> bd, "Can not create the output file %s.", file -> gzi);
+        else
+        {
+            entries = file -> entries / 2;     /* little-endian, as bgzip -i writes it */
+            fwrite(&entries, sizeof(entries), 1, gzi);
+            fwrite(file -> index, sizeof(uint64_t), file -> entries, gzi);
+            fclose(gzi);
+        }
+    }
+    Give(&file -> bd -> stat, BIODIFF_MEM_IO, file -> buf, BGZF_BATCH * BGZF_DATA);
+    Give(&file -> bd -> stat, BIODIFF_MEM_IO, file -> out, BGZF_BATCH * BGZF_BLOCK);
+    Give(&file -> bd -> stat, BIODIFF_MEM_IO, file -> index, sizeof(uint64_t) * file -> size);
+    free(file -> gzi);
+    free(file);
+    return status;
+}
+
+/******************************************************************************/
+/* Get_col: get a specific column from a line with separators according to c */
+static char *Get_col(char *line, char *col, char separator, int c)
+{
+    int count = 1; /* To count the occurrences of separators.*/
+    if (c < 1)
+    return NULL;
+    while (*line != '\0' && *line == separator )
+    line++;    /* To skip the separators at the beginning of the line.*/
+    while (*line != '\0' && count < c)
+    {
+        if (*line == separator)
+        {
+            while (*line != '\0' && *line == separator)
+            line++;        /* many separators are put together.*/
+            count++;
+        }
+        else
+        line++;
+    }
+    while (*line != '\0' && *line != '\n' && *line != separator) /* get specific column */
+       *col++ = *line++;
+    *col = 0;
+    return col;
+    
+}
+
+
+
+/******************************************************************************/
+/* Mark_range: set the bits of a bitmap from from to to, to excluded, whole bytes at once */
+static void Mark_range(unsigned char *bits, long from, long to)
+{
+    for (; from < to && from & 7; from++)
+        MARK(bits, from);
+    if (to - from >= 8)
+    {
+        memset(bits + (from >> 3), 0xff, (to - from) >> 3);
+        from += (to - from) & ~7L;
+    }
+    for (; from < to; from++)
+        MARK(bits, from);
+}
+
+/******************************************************************************/
+/* Run_end: the first of start[from..to-1] greater than x, to when there is none.
+   The kernels below do the same 8 or 16 at a time; Biodiff_create picks the widest
+   the processor has. */
+static long Run_end(const int *start, long from, long to, int x)
+{
+    while (from < to && start[from] <= x)
+        from++;
+    return from;
+}
+
+#ifdef BIODIFF_X86
+__attribute__((target("avx2")))
+static long Run_end_avx2(const int *start, long from, long to, int x)
+{
+    __m256i limit = _mm256_set1_epi32(x);
+    unsigned mask;
+    for (; to - from >= 8; from += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *) (start + from));
+        if ((mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, limit)))))
+            return from + __builtin_ctz(mask);
+    }
+    return Run_end(start, from, to, x);
+}
+
+__attribute__((target("avx512f")))
+static long Run_end_avx512(const int *start, long from, long to, int x)
+{
+    __m512i limit = _mm512_set1_epi32(x);
+    __mmask16 mask;
+    for (; to - from >= 16; from += 16)
+        if ((mask = _mm512_cmpgt_epi32_mask(_mm512_loadu_si512((const void *) (start + from)), limit)))
+            return from + __builtin_ctz(mask);
+    return Run_end(start, from, to, x);
+}
+#endif
+
+/******************************************************************************/
+/* Table_intervals: get and store the two columns of every row of a table, sorted.
+   The table is read once, so a pipe or a compressed file is decoded only once here;
+   a columnar table is not read at all, its columns point into the mapping. */
+static struct Interval *Table_intervals(Biodiff *bd, Biodiff_table *table)
+{
+    struct Cursor cursor;
+    char start[COLUMN_SIZE], end[COLUMN_SIZE];
+    struct Interval *interval;
+    int64_t *left, *right;
+    long size = 1024, l, runs = 1;   /* runs of rows already in order */
+    size_t k;
+    if (table -> interval)
+        return table -> interval;
+    if (table -> columns)
+    {
+        interval = (struct Interval *) Take_pages(bd, table -> stat, BIODIFF_MEM_ARRAYS, sizeof(struct Interval) * (table -> rows + 1));
+        left = Column_numbers(table -> columns, table -> col[0]);
+        right = Column_numbers(table -> columns, table -> col[1]);
+        for (l = 1; l <= table -> rows; ++l)
+        {
+            interval[l].start = Column_value(table -> columns, table -> col[0], l - 1);
+            interval[l].end = Column_value(table -> columns, table -> col[1], l - 1);
+            interval[l].left = left ? left[l - 1] : 0;
+            interval[l].right = right ? right[l - 1] : 0;
+            interval[l].row = l;
+            if (l > 1 && Cmp_interval(interval + l - 1, interval + l) > 0)
+                runs++;   /* a row out of order starts a new run */
+        }
+        return Keep_intervals(bd, table, interval, table -> rows, runs);
+    }
+    if (Open_rows(bd, table, &cursor))
+        return NULL;
+    interval = (struct Interval *) Take_pages(bd, table -> stat, BIODIFF_MEM_ARRAYS, sizeof(struct Interval) * size);
+    for (l = 1; Next_row(&cursor); ++l)
+    {
+        if (l == size)              /* the number of rows is not known in advance */
+        {
+            interval = (struct Interval *) Retake_pages(bd, table -> stat, BIODIFF_MEM_ARRAYS, interval, sizeof(struct Interval) * size, sizeof(struct Interval) * size * 2);
+            size *= 2;
+        }
+        *start = *end = 0;
+        Get_col(cursor.line, start, SEPARATORS, table -> col[0]);  /* get a specific column */
+        Get_col(cursor.line, end, SEPARATORS, table -> col[1]);
+        k = strlen(start) + 1;
+        interval[l].start = (char *) Take(table -> stat, BIODIFF_MEM_STRINGS, k + strlen(end) + 1);   /* both ends in one allocation */
+        interval[l].end = interval[l].start + k;
+        strcpy(interval[l].start, start);
+        strcpy(interval[l].end, end);
+        interval[l].left = atoi(start);   /* converted once, not at every comparison */
+        interval[l].right = atoi(end);
+        interval[l].row = l;
+        if (l > 1 && Cmp_interval(interval + l - 1, interval + l) > 0)
+            runs++;
+    }
+    if (Close_rows(bd, &cursor))
+    {
+        while (--l > 0)
+            Give(table -> stat, BIODIFF_MEM_STRINGS, interval[l].start, strlen(interval[l].start) + strlen(interval[l].end) + 2);
+        Give_pages(table -> stat, BIODIFF_MEM_ARRAYS, interval, sizeof(struct Interval) * size);
+        return NULL;
+    }
+    /* cut to the rows, so that the table knows the size of its intervals when it is released */
+    interval = (struct Interval *) Retake_pages(bd, table -> stat, BIODIFF_MEM_ARRAYS, interval, sizeof(struct Interval) * size, sizeof(struct Interval) * l);
+    return Keep_intervals(bd, table, interval, l - 1, runs);
+}
+
+/* Keep_intervals: sort the intervals of a table by their left end points and keep
+   them, with their end points as numbers in two arrays of their own. Intervals
+   already in order are kept as they are, long runs in order are merged, and only
+   intervals with little order left are sorted in full. A shard keeps its own intervals only */
+static struct Interval *Keep_intervals(Biodiff *bd, Biodiff_table *table, struct Interval *interval, long rows, long runs)
+{
+    int phase = Perf_phase(bd, BIODIFF_PHASE_SORT), close = 0;
+    if (bd -> opt.shards > 1)
+        interval = Shard_intervals(bd, table, interval, &rows, &close);
+    bd -> stat.sort_runs += runs;
+    if (runs <= 1)
+        bd -> stat.sort_skipped++;
+    else if (rows / runs >= MIN_RUN)
+    {
+        Merge_runs(bd, interval + 1, rows, runs);
+        bd -> stat.sort_merged++;
+    }
+    else
+    {
+        qsort(interval + 1, rows, sizeof(struct Interval), Cmp_interval);  /* qsort according to the left end point */
+        bd -> stat.sort_full++;
+    }
+    if (close)   /* after every other, and left of none */
+    {
+        rows++;
+        interval[rows].start = interval[rows].end = (char *) "";
+        interval[rows].left = interval[rows].right = INT_MAX;
+        interval[rows].row = 0;
+    }
+    table -> intervals = rows;
+    table -> left = (int *) Take_pages(bd, table -> stat, BIODIFF_MEM_ARRAYS, sizeof(int) * (rows + 1));
+    table -> right = (int *) Take_pages(bd, table -> stat, BIODIFF_MEM_ARRAYS, sizeof(int) * (rows + 1));
+    for (long l = 1; l <= rows; ++l)
+    {
+        table -> left[l] = interval[l].left;
+        table -> right[l] = interval[l].right;
+    }
+    Perf_phase(bd, phase);
+    return table -> interval = interval;
+}
+
+/* Shard_intervals: keep the intervals reaching into the span of the shard of the context, in
+   place, in an array cut to them. Sweep leaves out the last Y of the whole table; when that one
+   is in another shard, *close asks for one more interval to end this shard, so that its own
+   last Y is not left out. The runs in order stay runs, and no more of them. */
+static struct Interval *Shard_intervals(Biodiff *bd, Biodiff_table *table, struct Interval *interval, long *rows, int *close)
+{
+    int low = bd -> opt.shard ? bd -> opt.cuts[bd -> opt.shard - 1] : INT_MIN;
+    int high = bd -> opt.shard < bd -> opt.shards - 1 ? bd -> opt.cuts[bd -> opt.shard] : INT_MAX;
+    long i, kept = 0, last = 1;
+    for (i = 2; i <= *rows; ++i)   /* the last in order */
+        if (Cmp_interval(interval + i, interval + last) > 0)
+            last = i;
+    *close = *rows > 0;
+    for (i = 1; i <= *rows; ++i)
+    {
+        /* a Y is found by its left end point alone, whatever its right one */
+        if ((interval[i].right > interval[i].left ? interval[i].right : interval[i].left) >= low &&
+            (interval[i].left < high || bd -> opt.shard == bd -> opt.shards - 1))
+        {
+            if (i == last)
+                *close = 0;
+            interval[++kept] = interval[i];
+        }
+        else if (!table -> columns)
+            Give(table -> stat, BIODIFF_MEM_STRINGS, interval[i].start, strlen(interval[i].start) + strlen(interval[i].end) + 2);
+    }
+    interval = (struct Interval *) Retake_pages(bd, table -> stat, BIODIFF_MEM_ARRAYS, interval, sizeof(struct Interval) * (*rows + 1),
+                                                sizeof(struct Interval) * (kept + 1 + *close));
+    *rows = kept;
+    return interval;
+}
+
+/* Merge_runs: merge neighbouring runs in pairs, back and forth between the intervals
+   and a buffer, until one run is left; the runs are found again by comparison */
+static void Merge_runs(Biodiff *bd, struct Interval *interval, long rows, long runs)
+{
+    struct Interval *buffer = (struct Interval *) Take(&bd -> stat, BIODIFF_MEM_ARRAYS, sizeof(struct Interval) * rows), *from = interval, *to = buffer, *swap;
+    long *start = (long *) Take(&bd -> stat, BIODIFF_MEM_ARRAYS, sizeof(long) * (runs + 1)), i, j, k, n, r;
+
+    for (start[0] = 0, n = 1, i = 1; i < rows; ++i)   /* where every run starts */
+        if (Cmp_interval(interval + i - 1, interval + i) > 0)
+            start[n++] = i;
+    start[n] = rows;
+    while (n > 1)
+    {
+        for (r = 0; r < n; r += 2)
+        {
+            i = start[r], k = start[r];
+            if (r + 1 == n)   /* an odd run out is copied as it is */
+            {
+                memcpy(to + i, from + i, sizeof(struct Interval) * (start[r + 1] - i));
+                continue;
+            }
+            for (j = start[r + 1]; i < start[r + 1] && j < start[r + 2]; )
+                to[k++] = Cmp_interval(from + j, from + i) < 0 ? from[j++] : from[i++];   /* equal ones keep their order */
+            memcpy(to + k, from + i, sizeof(struct Interval) * (start[r + 1] - i));
+            k += start[r + 1] - i;
+            memcpy(to + k, from + j, sizeof(struct Interval) * (start[r + 2] - j));
+        }
+        for (r = 0; r < n; r += 2)   /* every merged pair starts where its first run did */
+            start[r / 2] = start[r];
+        n = (n + 1) / 2;
+        start[n] = rows;
+        swap = from, from = to, to = swap;
+    }
+    if (from != interval)
+        memcpy(interval, from, sizeof(struct Interval) * rows);
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, start, sizeof(long) * (runs + 1));
+    Give(&bd -> stat, BIODIFF_MEM_ARRAYS, buffer, sizeof(struct Interval) * rows);
+}
+
+/******************************************************************************/
+/* Cmp_coord: compare the left or right end point of a with the left end point of b,
+   as numbers or as strings; a constant coord leaves one of them in the caller */
+SPECIALIZE int Cmp_coord(int coord, const struct Interval *a, int end, const struct Interval *b)
+{
+    int x = end ? a -> right : a -> left;
+    if (coord == BIODIFF_COORD_STRING)
+        return strcmp(end ? a -> end : a -> start, b -> start);
+    return x < b -> left ? -1 : x > b -> left;
+}
+
+/******************************************************************************/
+/* Cmp_interval: the comparison function for qsort. */
+/* first according to left end point then right end point, equal ones keep their order */
+static int Cmp_interval(const void *a, const void *b)
+{
+    const struct Interval *x = (const struct Interval *) a, *y = (const struct Interval *) b;
+    int c = strcmp(x -> start, y -> start);
+    if (!c)
+        c = strcmp(x -> end, y -> end);
+    if (!c)
+        c = x -> row < y -> row ? -1 : x -> row > y -> row;
+    return c;
+}
+/******************************************************************************/
+/* Cmp_int: the comparison function for qsort of numbers */
+static int Cmp_int(const void *a, const void *b)
+{
+    int x = *(const int *) a, y = *(const int *) b;
+    return x < y ? -1 : x > y;
+}
+/******************************************************************************/
+/* Cmp_int64: the comparison function for qsort of 64-bit numbers */
+static int Cmp_int64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *) a, y = *(const int64_t *) b;
+    return x < y ? -1 : x > y;
+}
+/******************************************************************************/
+/* Cmp_span: the comparison function for qsort of spans, by their left end */
+static int Cmp_span(const void *a, const void *b)
+{
+    int64_t x = ((const struct Span *) a) -> left, y = ((const struct Span *) b) -> left;
+    return x < y ? -1 : x > y;
+}
+/******************************************************************************/
+/* Cmp_uint64: the comparison function for qsort of hashes */
+static int Cmp_uint64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return x < y ? -1 : x > y;
+}
+/******************************************************************************/
@@ -0,0 +1,287 @@
+//Library      : libbiodiff
+//Explaination : The comparisons of Biodiff for programs that embed them, on files, buffers or iterators.
+//Author       : YuanEnming
+//Build        : gcc -O2 -c biodiff.c && ar rcs libbiodiff.a biodiff.o
+//Link         : gcc -O2 program.c libbiodiff.a -lz -lpthread
+//Reentrant    : every call takes a Biodiff context and touches nothing global, so contexts
+//               may run in parallel. One context runs one call at a time. Tables of files
+//               and iterators are read while a call runs; buffer tables are only read, and
+//               once prepared they may be shared by calls of several contexts at once.
+
+#ifndef BIODIFF_H
+#define BIODIFF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BIODIFF_OK 0
+#define BIODIFF_ERROR -1
+#define BIODIFF_UNSPLIT 1      /* Biodiff_shard_cuts: the tables are compared whole, not in shards */
+
+#define BIODIFF_EQUAL 1        /* keys equal: [-ce] and [-ne] */
+#define BIODIFF_PREFIX 2       /* one key a prefix of the other: [-no] */
+#define BIODIFF_OVERLAP 3      /* intervals overlap: [-co] */
+#define BIODIFF_APPROX 4       /* keys within options.distance edits: [-na] */
+
+#define BIODIFF_MAX_TABLES 64  /* tables compared at once by Biodiff_compare_n */
+#define BIODIFF_MAX_KEY 8      /* columns of a key */
+#define BIODIFF_KEY_INT 0x10000    /* or'ed to a key column: its values compared as numbers */
+#define BIODIFF_KEY_FOLD 0x20000   /* or'ed to a key column: its values compared without case */
+
+#define BIODIFF_FOLD_CASE 1    /* keys compared without case */
+#define BIODIFF_FOLD_VERSION 2 /* keys compared without a version suffix like .3 */
+
+#define BIODIFF_PHASE_READ 0   /* taking the rows: reading, decoding and splitting them */
+#define BIODIFF_PHASE_BUILD 1  /* inserting keys in an index */
+#define BIODIFF_PHASE_PROBE 2  /* searching keys in an index */
+#define BIODIFF_PHASE_SORT 3   /* sorting intervals */
+#define BIODIFF_PHASE_SWEEP 4  /* sweeping intervals */
+#define BIODIFF_PHASE_WRITE 5  /* passing the rows to the result and its callback */
+#define BIODIFF_PHASES 6
+
+#define BIODIFF_EVENT_CYCLES 0
+#define BIODIFF_EVENT_INSTRUCTIONS 1
+#define BIODIFF_EVENT_LLC_MISSES 2    /* last-level cache read misses */
+#define BIODIFF_EVENT_DTLB_MISSES 3   /* data TLB read misses */
+#define BIODIFF_EVENT_BRANCH_MISSES 4
+#define BIODIFF_EVENTS 5
+
+#define BIODIFF_MEM_INDEX 0    /* trie, radix tree, hash table and Bloom filter nodes */
+#define BIODIFF_MEM_STRINGS 1  /* the column strings of the intervals */
+#define BIODIFF_MEM_ARRAYS 2   /* arrays by row: intervals, end points, offsets and marks */
+#define BIODIFF_MEM_IO 3       /* buffers of the inputs, the outputs and the batches */
+#define BIODIFF_MEM_TAGS 4
+
+#define BIODIFF_SKETCH_BITS 12 /* log2 of the HyperLogLog registers of a sketch */
+#define BIODIFF_SKETCH_K 1024  /* the smallest key hashes a sketch keeps */
+
+#define BIODIFF_DEPTHS 64      /* depths of the shape of a trie, the last for the deeper nodes */
+#define BIODIFF_FANOUTS 17     /* children of the shape of a trie, the last for more */
+
+#define BIODIFF_HUGE_THP 1     /* large blocks advised for transparent huge pages */
+#define BIODIFF_HUGE_TLB 2     /* large blocks from the reserved huge pages, THP when none are left */
+
+#define BIODIFF_NUMA_INTERLEAVE 1  /* large blocks interleaved over the memory nodes */
+
+#define BIODIFF_COORD_INT 1    /* coordinates compared as numbers */
+#define BIODIFF_COORD_STRING 2 /* coordinates compared as strings */
+
+#define BIODIFF_ENGINE_TRIE 1      /* in-memory trie, a radix tree for prefixes */
+#define BIODIFF_ENGINE_HASH 2      /* in-memory hash table, keys equal only */
+#define BIODIFF_ENGINE_PARTITION 3 /* keys split into temporary files, one partition in memory at a time */
+
+typedef struct Biodiff Biodiff;
+typedef struct Biodiff_table Biodiff_table;
+typedef struct Biodiff_writer Biodiff_writer;
+
+typedef struct Biodiff_options /* the options of a context, zero for the defaults. */
+{
+    int coord;                 /* BIODIFF_COORD_INT (default) or BIODIFF_COORD_STRING */
+    int engine;                /* BIODIFF_ENGINE_*, the trie by default */
+    int partitions;            /* number of partitions of the partition engine, 16 by default */
+    int threads;               /* threads decompressing and compressing BGZF blocks */
+    double bloom_fpr;          /* target false-positive rate of a Bloom pre-filter, 0 = off */
+    double mem_limit;          /* memory budget in bytes for Biodiff_plan */
+    int batch;                 /* keys probed together, with their cache misses overlapped, 32 by default */
+    int distance;              /* insertions, deletions and substitutions allowed by BIODIFF_APPROX */
+    int fold;                  /* BIODIFF_FOLD_* flags, applied to every key as it is read */
+    int perf;                  /* count hardware events by phase with perf_event_open, Linux only */
+    int shape;                 /* gather the shape of every trie and radix tree built in the stats */
+    int cover;                 /* [-co] also counts the base pairs covered by each table and by both in the stats */
+    int huge_pages;            /* BIODIFF_HUGE_*, 0 for the pages the kernel chooses, Linux only */
+    int numa;                  /* BIODIFF_NUMA_*, 0 for the node of the thread touching a page first */
+    /* with shards > 1, Biodiff_compare matches only the rows of shard, from 0: keys by a hash of
+       them in BIODIFF_EQUAL and by their first byte in BIODIFF_PREFIX, intervals reaching into
+       [cuts[shard - 1], cuts[shard]) in BIODIFF_OVERLAP; the other rows are passed unmatched, so
+       the results of all the shards OR'ed together are the result of the whole comparison. The
+       tables of such a context hold the indices and intervals of its shard only */
+    int shards, shard;
+    const int *cuts;           /* shards - 1 ascending coordinates, see Biodiff_shard_cuts */
+} Biodiff_options;
+
+typedef struct Biodiff_memory /* the memory held by one kind of structure. */
+{
+    long long bytes, peak;     /* held now and at most */
+    long blocks, peak_blocks;  /* allocations held now and at most */
+} Biodiff_memory;
+
+typedef struct Biodiff_stats /* counters of the calls of a context. */
+{
+    long bloom_probes;         /* probes that consulted a Bloom filter */
+    long bloom_rejects;        /* probes rejected by the filter alone */
+    long bloom_false;          /* probes passed by the filter but missed in the index */
+    long sort_skipped;         /* interval tables already in order, not sorted */
+    long sort_merged;          /* interval tables sorted by merging their runs in order */
+    long sort_full;            /* interval tables with little order, sorted in full */
+    long sort_runs;            /* runs in order found in all interval tables */
+    long approx_probes;        /* keys searched within a distance */
+    long approx_nodes;         /* radix tree nodes they visited */
+    long point_rows;           /* single positions of [-co] searched among the intervals of the other side, unsorted,
+                                  when the coordinates sort as strings the way they do as numbers */
+    long point_bounds;         /* bounds of the segments of those intervals they were searched in */
+    /* with options.cover, the base pairs of [-co] within the intervals of fileA, of fileB and of both,
+       both ends included; those of either are cover_A + cover_B - cover_both */
+    long long cover_A, cover_B, cover_both;
+    long cover_spans_A, cover_spans_B;   /* the intervals of each once the overlapping ones are merged */
+    long cover_sorted;         /* tables sorted again as numbers for it, their strings not in that order */
+    /* with options.perf, the events of the comparisons by phase, counted on the thread that
+       created the context, in user space; -1 for an event the processor or kernel does not count */
+    long long perf[BIODIFF_PHASES][BIODIFF_EVENTS];
+    /* the memory of the context, of the tables it created and of the results it filled, by
+       BIODIFF_MEM_*; the bitsets of a result are BIODIFF_MEM_ARRAYS until it is freed */
+    Biodiff_memory memory[BIODIFF_MEM_TAGS];
+    long long memory_peak;     /* bytes of every kind held at most at once */
+    /* with options.shape, the nodes of the tries and radix trees built */
+    long trie_nodes;
+    long trie_depth[BIODIFF_DEPTHS];   /* nodes by the bytes of key above them */
+    long trie_fanout[BIODIFF_FANOUTS]; /* nodes by their children */
+    long page_regions;         /* large blocks mapped for the trie nodes, the indices and the intervals */
+    long page_hugetlb;         /* of them from the reserved huge pages of BIODIFF_HUGE_TLB */
+} Biodiff_stats;
+
+typedef struct Biodiff_source /* records pulled one by one, like the lines of a file. */
+{
+    /* the next record and its length, NULL at the end; it stays valid until the next call */
+    const char *(*next)(void *arg, size_t *len);
+    /* start again from the first record, BIODIFF_OK or BIODIFF_ERROR */
+    int (*rewind)(void *arg);
+    void *arg;
+} Biodiff_source;
+
+typedef struct Biodiff_venn /* which tables hold a match of every row of each of n tables. */
+{
+    uint64_t *member[BIODIFF_MAX_TABLES]; /* a word for every row of table i: bit j when table j holds a match, bit i always */
+    long rows[BIODIFF_MAX_TABLES];
+    /* optional: called for every row with its record, the tables in order and the rows of a table in order */
+    void (*emit)(void *arg, int table, long row, uint64_t member, const char *record);
+    void *arg;
+    Biodiff_stats *stat;       /* set by the comparison: the counters its words are charged to */
+} Biodiff_venn;
+
+typedef struct Biodiff_region /* a span of coordinates, both ends included, as [-co] compares them. */
+{
+    const char *name;          /* the sequence, as in the sequence column of the index; NULL for any */
+    long start, end;
+} Biodiff_region;
+
+typedef struct Biodiff_sketch /* the distinct keys of a table in a few kilobytes, see Biodiff_sketch_table. */
+{
+    unsigned char reg[1 << BIODIFF_SKETCH_BITS];  /* HyperLogLog: the highest rank of the hashes of each register */
+    uint64_t bottom[BIODIFF_SKETCH_K];   /* MinHash: the smallest distinct hashes, ascending */
+    int k;                     /* how many, fewer when they are all the keys of the table */
+    int keys, col[BIODIFF_MAX_KEY], type[BIODIFF_MAX_KEY], fold;   /* how the keys were made, see Biodiff_table_file */
+    long long rows;
+} Biodiff_sketch;
+
+typedef struct Biodiff_similarity /* how alike the keys of two tables are, from their sketches. */
+{
+    double a, b;               /* distinct keys of each */
+    double both;               /* distinct keys of both */
+    double jaccard;            /* both over the distinct keys of either */
+    double a_error, b_error, both_error, jaccard_error;   /* their standard errors, 0 when they are exact */
+} Biodiff_similarity;
+
+typedef struct Biodiff_result /* which rows of each table have a match in the other. */
+{
+    unsigned char *matched[2]; /* bitsets of fileA [0] and fileB [1]: row i is bit i % 8 of byte i / 8 */
+    long rows[2];              /* rows of each table, empty lines are not rows */
+    /* optional: called for every row with its record, the rows of a table in order */
+    void (*emit)(void *arg, int side, long row, int matched, const char *record);
+    void *arg;
+    Biodiff_stats *stat;       /* set by the comparison: the counters its bitsets are charged to */
+} Biodiff_result;
+
+/* Biodiff_create: create a context with options, NULL for the defaults */
+Biodiff *Biodiff_create(const Biodiff_options *options);
+/* Biodiff_free: stop the threads of a context and release it */
+void Biodiff_free(Biodiff *bd);
+/* Biodiff_error: the message of the last error of a context */
+const char *Biodiff_error(Biodiff *bd);
+/* Biodiff_get_stats: the counters of a context */
+const Biodiff_stats *Biodiff_get_stats(Biodiff *bd);
+/* Biodiff_set_log: receive the lines a context reports, e.g. the plan */
+void Biodiff_set_log(Biodiff *bd, void (*log)(void *arg, const char *line), void *arg);
+
+/* Biodiff_table_file: a table of a plain, gzip, BGZF or columnar file, "-" for the standard input.
+   col holds the key columns, from 1, ended by a 0 or after BIODIFF_MAX_KEY of them, each maybe
+   or'ed with a BIODIFF_KEY_ type; [-co] takes the first two as the left and right coordinates.
+   A key of several columns or of a typed one is encoded, both tables must take the same types. */
+Biodiff_table *Biodiff_table_file(Biodiff *bd, const char *file_name, const int *col);
+/* Biodiff_table_buffer: a table of the lines in a buffer, which must outlive the table */
+Biodiff_table *Biodiff_table_buffer(Biodiff *bd, const char *data, size_t len, const int *col);
+/* Biodiff_table_source: a table of the records of an iterator */
+Biodiff_table *Biodiff_table_source(Biodiff *bd, const Biodiff_source *source, const int *col);
+/* Biodiff_load: read a whole plain, gzip, BGZF or columnar file into memory for Biodiff_table_buffer,
+   NULL on error; the caller releases it with free */
+char *Biodiff_load(Biodiff *bd, const char *file_name, size_t *len);
+/* Biodiff_load_from: read the complete lines of a file after its first offset bytes of decoded text,
+   for Biodiff_table_buffer; a last line without its newline is left out, so offset + *len is where
+   the next call starts once the file has grown. NULL on error, also when the file is now shorter */
+char *Biodiff_load_from(Biodiff *bd, const char *file_name, size_t offset, size_t *len);
+/* Biodiff_convert: convert a plain, gzip or BGZF file into a columnar file, which
+   Biodiff_table_file maps with its columns ready: every column dictionary-encoded, columns
+   of integers also sorted and delta-encoded, and the offsets of the original lines. Those are
+   offsets into a plain source, which must then stay unchanged, or into a copy of the decoded text */
+int Biodiff_convert(Biodiff *bd, const char *source, const char *target);
+/* Biodiff_index: build the binned index file_name.bdi of a plain or columnar file over its
+   sequence column, 0 for none, and the left and right coordinate columns in col */
+int Biodiff_index(Biodiff *bd, const char *file_name, int sequence, const int *col);
+/* Biodiff_table_region: a table of the records of an indexed file that overlap one of n
+   regions; only the byte ranges the index gives for them are read */
+Biodiff_table *Biodiff_table_region(Biodiff *bd, const char *file_name, const int *col, const Biodiff_region *region, int n);
+/* Biodiff_table_empty: whether a table has no record, 1 or 0, BIODIFF_ERROR when it can not be decoded */
+int Biodiff_table_empty(Biodiff *bd, Biodiff_table *table);
+/* Biodiff_table_prepare: build the index of a table for a mode now, to reuse it in later calls */
+int Biodiff_table_prepare(Biodiff *bd, Biodiff_table *table, int mode);
+/* Biodiff_table_free: release a table and its indices, before the context that created it,
+   which their memory is charged to */
+void Biodiff_table_free(Biodiff_table *table);
+
+/* Biodiff_plan: estimate the footprint of every engine and choose one within options.mem_limit */
+int Biodiff_plan(Biodiff *bd, int mode, Biodiff_table *A, Biodiff_table *B);
+/* Biodiff_compare: find the rows of A and B with a match in the other, BIODIFF_OK or BIODIFF_ERROR */
+int Biodiff_compare(Biodiff *bd, int mode, Biodiff_table *A, Biodiff_table *B, Biodiff_result *result);
+/* Biodiff_shard_cuts: the shards - 1 cuts of options.cuts that split the left end points of the intervals of
+   n tables into shards of about as many rows, from a sample of them; every table is read once.
+   BIODIFF_UNSPLIT when the left end points of a table do not sort as strings the way they sort as
+   numbers, as with numbers of other lengths: one comparison keeps to the strings, the shards could not */
+int Biodiff_shard_cuts(Biodiff *bd, Biodiff_table **table, int n, int shards, int *cuts);
+/* Biodiff_pass: pass every row of a table to a result as the bitset matched says, e.g. the results
+   of the shards of a comparison OR'ed together, like Biodiff_compare does */
+int Biodiff_pass(Biodiff *bd, Biodiff_table *table, int side, const unsigned char *matched, Biodiff_result *result);
+/* Biodiff_result_free: release the bitsets of a result, before the context that filled it */
+void Biodiff_result_free(Biodiff_result *result);
+/* Biodiff_compare_n: find for every row of n tables, at most BIODIFF_MAX_TABLES, which of them hold
+   a match in BIODIFF_EQUAL or BIODIFF_OVERLAP; every table is read twice at most, BIODIFF_OK or BIODIFF_ERROR */
+int Biodiff_compare_n(Biodiff *bd, int mode, Biodiff_table **table, int n, Biodiff_venn *venn);
+/* Biodiff_venn_free: release the words of a result, before the context that filled it */
+void Biodiff_venn_free(Biodiff_venn *venn);
+/* Biodiff_sketch_table: sketch the keys of a table in one pass, as [-ce] and [-ne] take them */
+int Biodiff_sketch_table(Biodiff *bd, Biodiff_table *table, Biodiff_sketch *sketch);
+/* Biodiff_sketch_save: write a sketch to a file, to estimate with it again without the table */
+int Biodiff_sketch_save(Biodiff *bd, const Biodiff_sketch *sketch, const char *file_name);
+/* Biodiff_sketch_load: read a sketch written by Biodiff_sketch_save */
+int Biodiff_sketch_load(Biodiff *bd, const char *file_name, Biodiff_sketch *sketch);
+/* Biodiff_estimate: estimate the distinct keys of two tables, of both and their Jaccard index
+   from their sketches, which must be of keys made alike; BIODIFF_OK or BIODIFF_ERROR */
+int Biodiff_estimate(Biodiff *bd, const Biodiff_sketch *A, const Biodiff_sketch *B, Biodiff_similarity *estimate);
+
+/* Biodiff_writer_open: create an output file, BGZF with the .gz suffix when bgzf is set,
+   with a .gzi index next to it when gzi is set */
+Biodiff_writer *Biodiff_writer_open(Biodiff *bd, const char *file_name, int bgzf, int gzi);
+/* Biodiff_writer_append: open a plain output file to add lines at its end, created when it is missing */
+Biodiff_writer *Biodiff_writer_append(Biodiff *bd, const char *file_name);
+/* Biodiff_write: write a line to an output file */
+void Biodiff_write(Biodiff_writer *file, const char *line);
+/* Biodiff_writer_close: finish an output file and its index, BIODIFF_OK or BIODIFF_ERROR */
+int Biodiff_writer_close(Biodiff_writer *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
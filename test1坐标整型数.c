@@ -6,196 +6,312 @@
 //Example      : Biodiff -no -a 0 -b 8 fileA fileB
 //Example      : Biodiff -ce -a 3,4 -b 3,4 fileA fileB
 //Example      : Biodiff -ne -a 0 -b 8 fileA fileB
+//Example      : Biodiff -na 1 --ignore-case --strip-version -a 0 -b 8 fileA fileB
+//Example      : Biodiff --serve /tmp/biodiff.sock -ne -a 1 -co -a 3,4 refA refB
+//Example      : Biodiff convert fileA fileA.bdc
+//Example      : Biodiff --state run.state -ne -a 0 -b 8 fileA growing-fileB
+//Example      : Biodiff --venn -co -a 3,4 file1 file2 file3 file4 file5
+//Example      : Biodiff index fileA 3,4 && Biodiff --region chr1:1000-2000 -co -a 3,4 -b 3,4 fileA fileB
+//Example      : Biodiff sketch fileA 1 fileA.bds && Biodiff --estimate -ne -a 1 -b 1 fileA.bds fileB
+//Example      : Biodiff --shards 8 --launcher 'ssh node$BIODIFF_SHARD' --shard-dir /shared/run -ne -a 1 -b 1 fileA fileB
+//Protocol     : a request is one line "mode reference col_b query", query being a file
+//               name or "- bytes" followed by that many bytes of records. The answer is
+//               "A&B_A rows bytes", "A-B ...", "A&B_B ...", "B-A ..." each followed by
+//               its bytes, then "stats ..." on one line; or "error message" on one line.
 //Date         : 2017/06/01
+//Build        : gcc -O2 -o Biodiff test1坐标整型数.c biodiff.c -lz -lpthread
+//               gcc -O2 -DDEFAULT_COORD=BIODIFF_COORD_STRING -o Biodiff test1坐标整型数.c biodiff.c -lz -lpthread
+//               for a build that compares the coordinates as strings unless --coord int is given.
+//Test         : sh tests/point_sweep.sh ./Biodiff
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include "biodiff.h"
 
-#define FILE_BUFFER 1024
-#define LINE_BUFFER 512
-#define COLUMN_SIZE 256
-#define BRANCH_SIZE 128
-#define NOTEXIST 0
-#define EXIST 1
-#define SEPARATORS '\t'
+#define REQUEST_SIZE 1024
+#define MAX_REFERENCES 64
+#define MAX_QUERY (1ULL << 32)   /* the most bytes of a query sent on the socket */
+#define SERVE_TIMEOUT 30         /* seconds a connection may wait without sending */
+#define STATE_MAGIC "BDSTATE\002"   /* the first 8 bytes of a --state file */
+#define MODES 5            /* the modes of Modes */
+#define MAX_VENN 16        /* files of --venn, every pattern of them gets a result file per file */
+#define SHARD_MAGIC "BDSHARD\001"   /* the first 8 bytes of the bitmaps of a worker of --shards */
+#define SKETCH_SUFFIX ".bds"         /* a file of --estimate named so is a sketch, see Sketch */
+#ifndef DEFAULT_COORD
+#define DEFAULT_COORD BIODIFF_COORD_INT   /* the coordinates without --coord, -DDEFAULT_COORD=BIODIFF_COORD_STRING for strings */
+#endif
 
 /******************************************************************************/
 
-struct TrieNode /* the defination of structure TrieNode. */
+struct Options /* extended options given as --name value. */
 {
-    int exist;
-    struct TrieNode *next[BRANCH_SIZE];
+    Biodiff_options lib;       /* the options of the library context */
+    int bgzf;                  /* write the results as BGZF */
+    int gzi;                   /* write a .gzi index next to every BGZF result */
+    char *serve;               /* the socket of the server, NULL to compare once */
+    Biodiff_region *region;    /* the regions to compare, read through the indices of the files */
+    int regions;
+    int sequence;              /* the sequence column of an index, 1 by default, 0 for none */
+    int venn;                  /* compare any number of files at once */
+    int annotate;              /* write the records of --venn to one file, tagged with their pattern */
+    char *state;               /* the checkpoint of an incremental run, NULL to compare everything */
+    int memory;                /* report the memory by kind and the shape of the tries at the end */
+    int estimate;              /* estimate how alike the keys are from sketches, without comparing them */
+    int shards;                /* worker processes comparing a shard each, 0 to compare here */
+    char *shard_dir;           /* where the workers leave their bitmaps, NULL for a temporary one */
+    char *launcher;            /* a command starting a worker elsewhere, NULL to start it here */
+    char *shard_out;           /* a worker: the file of its bitmaps */
+    int *cuts;                 /* a worker of [-co]: the cuts of the shards */
+    char **args;               /* the arguments as given, passed on to the workers */
+    int argn;
 };
 
-typedef struct TrieNode TrieNode;
+struct Reference /* a reference file the server keeps in memory, with a table per mode. */
+{
+    char *name;                /* the file name given on the command line */
+    char *data;
+    size_t len;
+    Biodiff_table *table[MODES];   /* by mode as in Modes, NULL for a mode not loaded */
+};
+
+struct State /* the checkpoint of --state: how far fileB has been compared and which rows of fileA matched. */
+{
+    char magic[8];             /* STATE_MAGIC */
+    int mode, col_A[BIODIFF_MAX_KEY + 1], col_B[BIODIFF_MAX_KEY + 1];
+    long long size_A, mtime_A; /* fileA, which must stay as it was, mtime in ns */
+    long long offset_B;        /* bytes of fileB compared, all of them whole lines */
+    long long rows_B;
+    long long rows_A;          /* followed by the bitset of the rows of fileA matched, rows_A / 8 + 1 bytes */
+};
 
+struct Shard_header /* the bitmaps a worker of --shards leaves for the coordinator. */
+{
+    char magic[8];             /* SHARD_MAGIC */
+    int shard, shards;
+    long long rows[2];         /* followed by the bitsets of fileA and fileB, (rows + 7) / 8 bytes each */
+};
+
+struct Answer /* a result set of a request, gathered before it is sent. */
+{
+    char *buf;
+    size_t len, size;
+    long rows;
+};
 
 
 /* an information function */
 void Info(int option);
-/* c_equal: coordinated-based equivalent differences */
-void c_equal(char *col_A,char *col_B, FILE *fileA, FILE *fileB,FILE *fileAB_A,FILE *fileAB_B, FILE *A_B, FILE *B_A);
-/* n_diff: name-based equivalent & overlap differences */
-void n_diff(int col_A, int col_B, FILE *fileA, FILE *fileB,FILE *fileAB_A, FILE *AB_B, FILE *A_B, FILE *B_A, int mode);
-/* c_overlap: coordinated-based overlap differences*/
-void c_overlap(char *col_A, char *col_B, char *file_name_a,char *file_name_b, FILE *fileA,FILE *fileB, FILE *fileAB_A, FILE *fileAB_B,FILE *fileA_B, FILE *fileB_A);
-/* create a tire tree root */
-TrieNode *Create_tire(void);
-/* insert a node to the trie tree */
-void Insert_trie(TrieNode *root, char *word);
-/* search for a string according to a trie tree based on total equal*/
-int Search_trie1(TrieNode *root, char *word);
-/* search for a string according to a trie tree based on prefix equal*/
-int Search_trie2(TrieNode *root, char *word);
-/* Get_col: get a specific column from a line with separators according to c */
-char *Get_col(char *line, char *col, char separator, int c);
-/* get_row: to get the number of rows from a specific file. */
-int Get_row(char *file);
-/* index_: creat index from 1 to row. */
-int *index_(int row);
-/* advector: create an adjoint vector for the whole file to mark whether a row is overlap.*/
-int *advector(int row);
-/* store_col: get and store the specific column from a file.*/
-char** store_col(int row, char *file_name, int column);
-
-/* define globle variables for cmp_A & cmp_B */
-char ***Columns_A;
-char ***Columns_B;
-/* cmp_A & cmp_B : the comparison function for qsort. */
-int cmp_A(const void *a, const void *b);
-int cmp_B(const void *a, const void *b);
+/* Error: print the last error of the library and exit */
+void Error(Biodiff *bd);
+/* Emit: write a row to the result file of its side and its mark */
+void Emit(void *arg, int side, long row, int matched, const char *record);
+/* Log: print a line reported by the library */
+void Log(void *arg, const char *line);
+/* Print_perf: print the hardware events of --perf by phase */
+void Print_perf(const Biodiff_stats *stat, long records);
+/* Print_memory: print the memory of --memory by kind and the shape of the tries */
+void Print_memory(const Biodiff_stats *stat);
+/* Get_size: parse a size like 512M or 4G */
+double Get_size(char *arg);
+/* Get_cols: parse the key columns separated by ',', each maybe with its type, -1 when they are not */
+int Get_cols(char *arg, int *col);
+/* Get_options: take the --options out of argv and return the number of arguments left */
+int Get_options(int argc, char *argv[]);
+/* Get_mode: the number of a mode in Modes, -1 for none */
+int Get_mode(char *arg);
+/* Convert: convert an input file into a columnar file that every mode reads without parsing */
+void Convert(char *source, char *target);
+/* Index: build the binned index of an input file for --region */
+void Index(char *file_name, char *cols);
+/* Sketch: sketch the keys of an input file for --estimate */
+void Sketch(char *file_name, char *cols, char *target);
+/* Estimate: estimate how alike the keys of two files are, from sketches read or made in one pass */
+void Estimate(int mode, int *col_A, int *col_B, char *name_A, char *name_B);
+/* Sketch_file: the sketch of an input file, read from it when it is a sketch already */
+void Sketch_file(Biodiff *bd, char *file_name, int *col, Biodiff_sketch *sketch);
+/* Add_region: add a region given as name:start-end, or start-end for any sequence */
+void Add_region(char *arg);
+/* Read_regions: add the regions of a BED file, name start end on every line */
+void Read_regions(char *file_name);
+/* Serve: keep the references in memory and answer requests on a Unix socket */
+void Serve(int argc, char *argv[]);
+/* Serve_worker: a thread of the server, answering one connection at a time */
+void *Serve_worker(void *arg);
+/* Serve_request: read a request from a connection and send the answer */
+void Serve_request(int client);
+/* Gather: add a row to the result set of its side and its mark */
+void Gather(void *arg, int side, long row, int matched, const char *record);
+/* Incremental: compare only the records appended to fileB since the last run of a --state file */
+void Incremental(int mode, int *col_A, int *col_B, char *name_A, char *name_B);
+/* Emit_state: write a row of --state, a row of fileA as matched when it was in an earlier run */
+void Emit_state(void *arg, int side, long row, int matched, const char *record);
+/* Shards: compare in worker processes, a shard each, and merge their bitmaps into the result */
+int Shards(Biodiff *bd, int mode, Biodiff_table *fileA, Biodiff_table *fileB, Biodiff_result *result);
+/* Launch: start the worker of a shard, here or with --launcher */
+pid_t Launch(int shard, char **args);
+/* Shard_worker: compare one shard and leave its bitmaps for the coordinator */
+void Shard_worker(Biodiff *bd, int mode, Biodiff_table *fileA, Biodiff_table *fileB);
+/* Venn: compare many files at once and write their records by the files holding a match */
+void Venn(int argc, char *argv[]);
+/* Partition: write a row of --venn to the result file of its file and its pattern */
+void Partition(void *arg, int table, long row, uint64_t member, const char *record);
+/* Annotate: write a row of --venn to one result file, tagged with its file and its pattern */
+void Annotate(void *arg, int table, long row, uint64_t member, const char *record);
+/* Get_pattern: the pattern of a word of files, '1' for a file holding a match and '0' for another */
+char *Get_pattern(uint64_t member, char *pattern);
+
+/* define globle variables for the extended options */
+struct Options Opt;
+/* the modes, what the library compares in each, and the result files by side and mark */
+const char *Modes[MODES] = {"-ce", "-ne", "-no", "-co", "-na"};
+const int Compare[MODES] = {BIODIFF_EQUAL, BIODIFF_EQUAL, BIODIFF_PREFIX, BIODIFF_OVERLAP, BIODIFF_APPROX};
+const char *Targets[4] = {"A&B_A", "A-B", "A&B_B", "B-A"};
+const char *Phases[BIODIFF_PHASES] = {"read", "build", "probe", "sort", "sweep", "write"};
+const char *Kinds[BIODIFF_MEM_TAGS] = {"index", "strings", "arrays", "io"};
+/* define globle variables for the server */
+struct Reference References[MAX_REFERENCES];
+int References_n;
+int Listener;
+/* define globle variables for --state: the checkpoint and the rows of fileA matched before */
+struct State State;
+unsigned char *State_matched;
+/* define globle variables for --venn: the files, their result files by pattern and rows by pattern */
+int Venn_files;
+Biodiff_writer **Venn_target;
+long *Venn_rows;
 /******************************************************************************/
 int main(int argc, char *argv[])
 {
-    FILE *fileA, *fileB, *fileAB_A, *fileAB_B, *fileA_B, *fileB_A;
-    
-    
+    Biodiff *bd;
+    Biodiff_table *fileA, *fileB;
+    Biodiff_writer *target[4];   /* as in Targets: by side, then by mark */
+    Biodiff_result result = {{NULL, NULL}, {0, 0}, Emit, target};
+    const Biodiff_stats *stat;
+    long long either;
+    int col_A[BIODIFF_MAX_KEY + 1], col_B[BIODIFF_MAX_KEY + 1], mode, empty, i;
+
+
+    Opt.sequence = 1;
+    Opt.argn = argc;    /* Get_options takes the options out of argv */
+    Opt.args = (char **) memcpy(malloc(sizeof(char *) * (argc + 1)), argv, sizeof(char *) * (argc + 1));
+    argc = Get_options(argc, argv);   /* the positional arguments are left in argv[1..7] */
+    if (!Opt.lib.coord)
+        Opt.lib.coord = DEFAULT_COORD;
+    if (Opt.serve)
+        Serve(argc, argv);
+    if (Opt.venn)
+        Venn(argc, argv);
+    if (argc == 4 && !strcmp(argv[1], "convert"))
+        Convert(argv[2], argv[3]);
+    if (argc == 4 && !strcmp(argv[1], "index"))
+        Index(argv[2], argv[3]);
+    if (argc == 5 && !strcmp(argv[1], "sketch"))
+        Sketch(argv[2], argv[3], argv[4]);
     if(argc == 1)
         Info(0);     /* print the usage information */
     else if(argc != 8)
         Info(1);     /* usage error */
-    if ((fileA = fopen(argv[6],"r")) == NULL || (fileB = fopen(argv[7],"r")) == NULL)
-        Info(2);     /* open the input file . fileA and fileB should be openable*/
-    char ch1=fgetc(fileA), ch2=fgetc(fileB);
-    if ( ch1 == EOF || ch2 ==EOF )
+    if ((mode = Get_mode(argv[1])) < 0)
+        Info(4);     /* usage error */
+    mode = Compare[mode];
+    if (Get_cols(argv[3], col_A) || Get_cols(argv[5], col_B))
+        Info(5);
+    if (Opt.estimate)
+        Estimate(mode, col_A, col_B, argv[6], argv[7]);
+    if (Opt.shards && (mode == BIODIFF_APPROX || Opt.state || Opt.lib.cover))
+    {
+        printf("Error: --shards splits [-ce], [-ne], [-no] and [-co], without --state or --cover.\n");
+        exit(1);
+    }
+    if (Opt.state)
+        Incremental(mode, col_A, col_B, argv[6], argv[7]);
+
+    bd = Biodiff_create(&Opt.lib);
+    Biodiff_set_log(bd, Log, NULL);
+    if (Opt.regions)   /* only the records in the regions */
+    {
+        if (!(fileA = Biodiff_table_region(bd, argv[6], col_A, Opt.region, Opt.regions)) ||
+            !(fileB = Biodiff_table_region(bd, argv[7], col_B, Opt.region, Opt.regions)))
+            Error(bd);
+    }
+    else if (!(fileA = Biodiff_table_file(bd, argv[6], col_A)) || !(fileB = Biodiff_table_file(bd, argv[7], col_B)))
+        Error(bd);   /* open the input file . fileA and fileB should be openable*/
+    if (Opt.lib.coord == BIODIFF_COORD_INT && ((empty = Biodiff_table_empty(bd, fileA)) || (empty = Biodiff_table_empty(bd, fileB))))
     {
+        if (empty < 0)
+            Error(bd);
         printf("Empty file!\n");
         exit(1);
     }
-    
-    /* set buffer for the input streams*/
-    setvbuf(fileA, NULL, _IOFBF, FILE_BUFFER);
-    setvbuf(fileB, NULL, _IOFBF, FILE_BUFFER);
-    
+
+    /* choose the engine within the memory limit, every worker of --shards for its shard */
+    if (Opt.lib.mem_limit && !Opt.shards && Biodiff_plan(bd, mode, fileA, fileB))
+        Error(bd);
+    if (Opt.shard_out)
+        Shard_worker(bd, mode, fileA, fileB);
+
     /* create target files */
-    if (!(fileAB_A = fopen("A&B_A", "w")) ||
-        !(fileAB_B = fopen("A&B_B", "w")) ||
-        !(fileA_B  = fopen("A-B", "w")) ||
-        !(fileB_A  = fopen("B-A", "w")))
-        Info(3);     /* create false */
-    
-    /* set buffer for the output streams */
-    setvbuf(fileAB_A, NULL, _IOFBF, FILE_BUFFER);
-    setvbuf(fileAB_B, NULL, _IOFBF, FILE_BUFFER);
-    setvbuf(fileA_B, NULL, _IOFBF, FILE_BUFFER);
-    setvbuf(fileB_A, NULL, _IOFBF, FILE_BUFFER);
-    
+    for (i = 0; i < 4; i++)
+        if (!(target[i] = Biodiff_writer_open(bd, Targets[i], Opt.bgzf, Opt.gzi)))
+            Error(bd);   /* create false */
+
     /* to record the time */
     clock_t start = clock();
-    if (!strcmp(argv[1], "-ce"))  /* use [-ce] mode */
-        c_equal(argv[3],argv[5],fileA,fileB,fileAB_A,fileAB_B,fileA_B,fileB_A);
-    else if (!strcmp(argv[1], "-ne")) /* use [-ne] mode */
-        n_diff(atoi(argv[3]),atoi(argv[5]),fileA,fileB,fileAB_A,fileAB_B,fileA_B,fileB_A, 1);
-    else if (!strcmp(argv[1], "-no")) /* use [-no] mode */
-        n_diff(atoi(argv[3]),atoi(argv[5]),fileA,fileB,fileAB_A,fileAB_B,fileA_B,fileB_A, 2);
-    else if (!strcmp(argv[1], "-co")) /* use [-co] mode */
-        c_overlap(argv[3], argv[5], argv[6], argv[7], fileA,fileB,fileAB_A,fileAB_B,fileA_B,fileB_A);
-    else          /* usage error */
-        Info(4);
+    if (Opt.shards ? Shards(bd, mode, fileA, fileB, &result) : Biodiff_compare(bd, mode, fileA, fileB, &result))
+        Error(bd);
     clock_t end = clock();
     printf("%lu min %lu s %lu ms\n", (end - start) / (60 * CLOCKS_PER_SEC), (end - start) % (60 * CLOCKS_PER_SEC) / CLOCKS_PER_SEC, (end - start) % (60 * CLOCKS_PER_SEC) % CLOCKS_PER_SEC * 1000 / CLOCKS_PER_SEC);
-    
-    /* close the opend files */
-    fclose(fileA);
-    fclose(fileB);
-    fclose(fileAB_A);
-    fclose(fileAB_B);
-    fclose(fileA_B);
-    fclose(fileB_A);
-    
-    printf("Complete!\n");
-    return 0;
-}
-/******************************************************************************/
-/* create a tire tree root */
-TrieNode *Create_tire(void)
-{
-    TrieNode *temp = (TrieNode *) malloc(sizeof(TrieNode)); /* apply for space */
-    temp -> exist = NOTEXIST;                              /* initialization */
-    for(int i = 0; i < BRANCH_SIZE; i++)                   /* initialization */
-        temp -> next[i] = NULL;
-    return temp;
-}
-/******************************************************************************/
-/* insert a node to the trie tree */
-void Insert_trie(TrieNode * root, char *col)
-{
-    TrieNode *temp = root;
-    for(int i; *col; col++)
+    stat = Biodiff_get_stats(bd);
+    if (stat -> bloom_probes)   /* report how well the Bloom filter worked */
+        printf("Bloom filter: %ld probes, %ld rejected by the filter (%.1f%%), %ld false positives\n",
+               stat -> bloom_probes, stat -> bloom_rejects, 100.0 * stat -> bloom_rejects / stat -> bloom_probes, stat -> bloom_false);
+    if (stat -> sort_skipped + stat -> sort_merged + stat -> sort_full)   /* report how the intervals were sorted */
+        printf("Sort: %ld tables already in order, %ld merged from their runs, %ld sorted in full (%ld runs)\n",
+               stat -> sort_skipped, stat -> sort_merged, stat -> sort_full, stat -> sort_runs);
+    if (stat -> approx_probes)   /* report how much of the radix trees the searches within the distance visited */
+        printf("Distance %d: %ld keys searched, %ld nodes visited (%.1f per key)\n",
+               Opt.lib.distance, stat -> approx_probes, stat -> approx_nodes, (double) stat -> approx_nodes / stat -> approx_probes);
+    if (stat -> point_rows)   /* report the single positions searched without sorting them */
+        printf("Points: %ld positions searched among %ld bounds\n", stat -> point_rows, stat -> point_bounds);
+    if (Opt.lib.cover && mode == BIODIFF_OVERLAP)   /* report the base pairs of the intervals */
     {
-        i = *col;
-        if (temp -> next[i])           /* node existed already */
-            ;
-        else
-            temp -> next[i] = Create_tire(); /* create a new node */
-        temp = temp -> next[i];           /* point to next node */
+        either = stat -> cover_A + stat -> cover_B - stat -> cover_both;
+        printf("Cover: fileA %lld bp in %ld merged intervals, fileB %lld bp in %ld merged intervals\n",
+               stat -> cover_A, stat -> cover_spans_A, stat -> cover_B, stat -> cover_spans_B);
+        printf("Cover: %lld bp in both, %lld bp in either, Jaccard %.4f\n", stat -> cover_both, either,
+               either ? (double) stat -> cover_both / either : 0.0);
+        if (stat -> cover_sorted)
+            printf("Cover: the coordinates of %ld files were sorted again as numbers, their lengths differ\n", stat -> cover_sorted);
     }
-    temp -> exist = EXIST;               /* complete an insertion and record it */
-}
+    if (stat -> page_regions && (Opt.lib.huge_pages || Opt.lib.numa))   /* report where the large blocks came from */
+        printf("Pages: %ld large blocks mapped, %ld of them from the reserved huge pages\n", stat -> page_regions, stat -> page_hugetlb);
+    if (Opt.lib.perf)
+        Print_perf(stat, result.rows[0] + result.rows[1]);
 
-/******************************************************************************/
-/* search for a string according to a trie tree based on total equal.*/
-int Search_trie1(TrieNode *root, char *str)
-{
-    int i;
-    TrieNode *temp = root;
-    if (!temp)  /* tire tree must not be empty */
-        return 0;
-    for(int i; *str; str++)
-    {
-        i = *str;
-        if(temp -> next[i])    /* if a specific character exist, point to the next one*/
-            temp = temp -> next[i];
-        else           /* not match */
-            return 0;
-    }
-    if (temp -> exist)  /* match */
-        return EXIST;
-    else                /* include but not equal */
-        return NOTEXIST;
-}
+    /* close the opend files */
+    Biodiff_result_free(&result);
+    Biodiff_table_free(fileA);
+    Biodiff_table_free(fileB);
+    for (i = 0; i < 4; i++)
+        if (Biodiff_writer_close(target[i]))
+            Error(bd);
+    if (Opt.memory)
+        Print_memory(stat);
+    Biodiff_free(bd);
 
-/******************************************************************************/
-/* search for a string according to a trie tree based on prefix*/
-int Search_trie2(TrieNode *root, char *str)
-{
-    int i;
-    TrieNode *temp = root;
-    if (!temp)  /* tire tree must not be empty */
+    printf("Complete!\n");
     return 0;
-    for(int i; *str; str++)
-    {
-        i = *str;
-        if(temp -> next[i])    /* if a specific character exist, point to the next one*/
-            temp = temp -> next[i];
-        else           /* not match */
-            return NOTEXIST;
-    }
-    return EXIST;      /* include */
 }
-
 /******************************************************************************/
 /* an information function to help users*/
 void Info(int option)
@@ -213,403 +329,1176 @@ void Info(int option)
             printf("#  Example: Biodiff -ne -a 0 -b 8 fileA fileB                       #\n");
             printf("#  Example: Biodiff -co -a 3,4 -b 3,4 fileA fileB                   #\n");
             printf("#  Example: Biodiff -no -a 0 -b 8 fileA fileB                       #\n");
+            printf("#  Example: Biodiff -na 1 --ignore-case -a 0 -b 8 fileA fileB       #\n");
             printf("#####################################################################\n");
             printf("#  > * [-ce] : coordinate-based equivalent comparation;             #\n");
             printf("#  > * [-ne] : name-based equivalent comparation;                   #\n");
             printf("#  > * [-co] : coordinate-based overlap comparation;                #\n");
             printf("#  > * [-no] : name-based overlap comparation;                      #\n");
-            printf("#  > * In [-ne]or[-no] mode you only need to select one column;     #\n");
-            printf("#  > * In [-ce]or[-co] mode 2 columns separated by ',' are required #\n");
+            printf("#  > * [-na k] : name-based comparation within k insertions,        #\n");
+            printf("#               deletions or substitutions, e.g. -na 1;             #\n");
+            printf("#  > * A key is one column or several separated by ',', any of them #\n");
+            printf("#      with :i to compare it as a number or :f without case, e.g.   #\n");
+            printf("#      -ne -a 1,2:i,4,5:f -b 1,2:i,4,5:f, the same types on both    #\n");
+            printf("#  > * In [-co] mode the 2 columns of the coordinates are required  #\n");
+            printf("#  > * In [-co] single positions, start = end, against intervals are#\n");
+            printf("#      searched unsorted only when the coordinates sort as strings  #\n");
+            printf("#      the way they do as numbers, e.g. all of as many digits       #\n");
             printf("#  > * Here 'name-based overlap' means that the name prefix overlap #\n");
             printf("#####################################################################\n");
+            printf("#  Options:                                                         #\n");
+            printf("#  > * --bloom rate : Bloom pre-filter for [-ce]or[-ne] probes with #\n");
+            printf("#                     a target false-positive rate, e.g. 0.01       #\n");
+            printf("#  > * --mem-limit size : estimate the memory footprint and choose  #\n");
+            printf("#                     the trie, hash or partition engine, e.g. 4G   #\n");
+            printf("#  > * --engine trie|hash|partition : choose the engine directly    #\n");
+            printf("#  > * --coord int|string : compare the coordinates as numbers      #\n");
+            printf("#                     or as strings, by default as the build says   #\n");
+            printf("#  > * --threads n : threads for BGZF input and output              #\n");
+            printf("#  > * --huge-pages thp|hugetlb : map the trie nodes, the indices   #\n");
+            printf("#                     and the intervals in huge pages, hugetlb from #\n");
+            printf("#                     the reserved ones while any are left          #\n");
+            printf("#  > * --numa interleave : spread those pages over the memory nodes #\n");
+            printf("#  > * --batch n : keys probed together, 1 to 64, 32 by default     #\n");
+            printf("#  > * --bgzf : write the results as BGZF files with a .gz suffix   #\n");
+            printf("#  > * --gzi : also write a .gzi index for every BGZF result        #\n");
+            printf("#  > * --ignore-case : compare the keys without case, BRCA1 = Brca1 #\n");
+            printf("#  > * --strip-version : drop a version like .3 at the end of a key,#\n");
+            printf("#                     ENST0001.3 = ENST0001.4                       #\n");
+            printf("#  > * --perf : count the cycles, instructions, LLC, dTLB and branch#\n");
+            printf("#                     misses of every phase with perf_event_open    #\n");
+            printf("#  > * --memory : report the memory held by kind and the shape of   #\n");
+            printf("#                     the tries at the end                          #\n");
+            printf("#  > * --region seq:start-end : compare only the records that       #\n");
+            printf("#                     overlap it, or start-end in any sequence      #\n");
+            printf("#  > * --regions bed : the regions of a BED file, seq start end     #\n");
+            printf("#  > * --state file : compare only the records appended to fileB    #\n");
+            printf("#                     since the last run with the file, which keeps #\n");
+            printf("#                     how far fileB was read and the rows of fileA  #\n");
+            printf("#                     matched; A&B_B and B-A grow, A&B_A and A-B are#\n");
+            printf("#                     written again; not for [-co]                  #\n");
+            printf("#  > * --shards n : split [-ce][-ne][-no] by key and [-co] by       #\n");
+            printf("#                     coordinates over n worker processes, and      #\n");
+            printf("#                     merge the bitmaps they leave in row order;    #\n");
+            printf("#                     [-co] runs whole unless the coordinates sort  #\n");
+            printf("#                     as strings the way they do as numbers         #\n");
+            printf("#  > * --shard-dir dir : where the workers leave them, a directory  #\n");
+            printf("#                     all the nodes share with --launcher           #\n");
+            printf("#  > * --launcher cmd : start every worker with cmd, e.g. 'ssh      #\n");
+            printf("#                     node$BIODIFF_SHARD', the number of its shard  #\n");
+            printf("#  > * --cover : also count the base pairs of [-co] within fileA,   #\n");
+            printf("#                     fileB, both and either and their Jaccard      #\n");
+            printf("#                     index, the overlapping intervals merged       #\n");
+            printf("#  > * --estimate : estimate the distinct keys of [-ce][-ne] in     #\n");
+            printf("#                     each file and in both and their Jaccard       #\n");
+            printf("#                     index from sketches made in one pass, or      #\n");
+            printf("#                     read from the .bds files of Biodiff sketch    #\n");
+            printf("#  > * Input files may be plain, gzip or BGZF, '-' reads stdin      #\n");
+            printf("#####################################################################\n");
+            printf("#  Convert: Biodiff convert file file.bdc                           #\n");
+            printf("#  > * writes a columnar file of the records, their columns encoded #\n");
+            printf("#      once; it is read in every mode in place of the file, without #\n");
+            printf("#      parsing, and the results still hold the original lines;      #\n");
+            printf("#      a plain file is read through its path, not copied, and must  #\n");
+            printf("#      not change afterwards                                        #\n");
+            printf("#####################################################################\n");
+            printf("#  Index: Biodiff index file 3,4 [--sequence 1]                     #\n");
+            printf("#  > * writes file.bdi, binning the records by the coordinates in   #\n");
+            printf("#      columns 3,4 and the sequence names in column 1, 0 for none;  #\n");
+            printf("#      --region reads only the bytes it needs through it; the file  #\n");
+            printf("#      must be plain or columnar                                    #\n");
+            printf("#####################################################################\n");
+            printf("#  Sketch: Biodiff sketch file 1,2:i file.bds                       #\n");
+            printf("#  > * writes the sketch of the keys in the columns, a few          #\n");
+            printf("#      kilobytes --estimate reads in place of the file with the     #\n");
+            printf("#      same columns, --ignore-case and --strip-version              #\n");
+            printf("#####################################################################\n");
+            printf("#  Venn: Biodiff --venn [-ce -ne -co] [-a col]... file file...      #\n");
+            printf("#  > * compares up to 16 files at once, every file read twice at    #\n");
+            printf("#      most; the n-th -a gives the columns of the n-th file and the #\n");
+            printf("#      last one those of the files after it;                        #\n");
+            printf("#  > * a record goes to Venn_P_i, i its file and P the files holding#\n");
+            printf("#      a match, e.g. Venn_1101_2 for the files 1, 2 and 4;          #\n");
+            printf("#  > * --annotate : one result file Venn, 'i P record' on each line #\n");
+            printf("#####################################################################\n");
+            printf("#  Server: Biodiff --serve socket [mode -a col_a]... ref [ref]...   #\n");
+            printf("#  > * keeps the refs and their indices for each mode in memory and #\n");
+            printf("#      answers requests on a Unix socket, --threads at a time;      #\n");
+            printf("#  > * a request is 'mode ref col_b query', the query a file or     #\n");
+            printf("#      '- bytes' and that many bytes of records, up to 4 GB; a      #\n");
+            printf("#      connection silent for 30 s is closed                         #\n");
+            printf("#  > * the answer is the four result sets and a line of stats       #\n");
+            printf("#####################################################################\n");
             exit(1);
             break;
         case 1:
-            printf("Usage: Biodiff [-ce -ne -co -no] -a col_a -b col_b fileA fileB.\n");
-            exit(1);
-        case 2:
-            printf("Error: Can not open the input files.\n");
-            exit(1);
-        case 3:
-            printf("Error: Can not create the output files.\n");
+            printf("Usage: Biodiff [-ce -ne -co -no -na k] -a col_a -b col_b fileA fileB.\n");
             exit(1);
         case 4:
-            printf("Usage: Biodiff [-ce -ne -co -no] -a col_a -b col_b fileA fileB.\n");
+            printf("Usage: Biodiff [-ce -ne -co -no -na k] -a col_a -b col_b fileA fileB.\n");
             printf("       You should choose one mode.\n");
             exit(1);
+        case 5:
+            printf("Error: Unknown option or missing option value.\n");
+            exit(1);
     }
 }
+
 /******************************************************************************/
-/* c_equal: coordinated-based equivalent differences */
-void c_equal(char *col_A, char *col_B, FILE *fileA,
-            FILE *fileB, FILE *fileAB_A, FILE *fileAB_B,
-            FILE *fileA_B, FILE *fileB_A)
-{
-    char colA1s[4], colA2s[4], colB1s[4], colB2s[4];
-    Get_col(col_A, colA1s, ',', 1);
-    Get_col(col_A, colA2s, ',', 2);
-    Get_col(col_A, colB1s, ',', 1);
-    Get_col(col_B, colB2s, ',', 2);
-    int col_A1 = atoi(colA1s);
-    int col_A2 = atoi(colA2s);
-    int col_B1 = atoi(colB1s);
-    int col_B2 = atoi(colB2s);
-    
-    char line_A[LINE_BUFFER];       /* A buffer to store a line from fileA*/
-    char line_B[LINE_BUFFER];       /* A buffer to store a line from fileB*/
-    char column_A1[COLUMN_SIZE];    /* A buffer to store a column from fileA's line*/
-    char column_A2[COLUMN_SIZE];    /* A buffer to store a column from fileA's line*/
-    char column_B1[COLUMN_SIZE];    /* A buffer to store a column from fileB's line*/
-    char column_B2[COLUMN_SIZE];    /* A buffer to store a column from fileB's line*/
-    TrieNode *root_A = Create_tire();   /* create a root node*/
-    TrieNode *root_B = Create_tire();
-    
-    while (fgets(line_A, LINE_BUFFER, fileA) != NULL)/* build a tire tree according to fileA */
-    {
-        if (*line_A == '\n')
-            ;    /* skip the empty lines */
+/* Error: print the last error of the library and exit */
+void Error(Biodiff *bd)
+{
+    printf("Error: %s\n", Biodiff_error(bd));
+    exit(1);
+}
+
+/******************************************************************************/
+/* Emit: write a row to the result file of its side and its mark */
+void Emit(void *arg, int side, long row, int matched, const char *record)
+{
+    Biodiff_writer **target = (Biodiff_writer **) arg;
+    Biodiff_write(target[side * 2 + !matched], record);
+}
+
+/******************************************************************************/
+/* Log: print a line reported by the library */
+void Log(void *arg, const char *line)
+{
+    printf("%s\n", line);
+}
+
+/******************************************************************************/
+/* Print_perf: print the hardware events of --perf by phase, the misses per record of
+   all files; n/a for an event the processor or the kernel does not count */
+void Print_perf(const Biodiff_stats *stat, long records)
+{
+    int p, e;
+    for (e = 0; e < BIODIFF_EVENTS && stat -> perf[0][e] < 0; e++)
+        ;
+    if (e == BIODIFF_EVENTS)
+    {
+        printf("Perf: no hardware counter could be opened, see /proc/sys/kernel/perf_event_paranoid\n");
+        return;
+    }
+    printf("Perf: %-6s %14s %14s %6s %14s %14s %14s\n", "phase", "cycles", "instructions", "IPC",
+           "LLC miss/rec", "dTLB miss/rec", "branch miss/rec");
+    for (p = 0; p < BIODIFF_PHASES; p++)
+    {
+        for (e = 0; e < BIODIFF_EVENTS && stat -> perf[p][e] <= 0; e++)
+            ;
+        if (e == BIODIFF_EVENTS)
+            continue;    /* a phase the mode does not have */
+        printf("Perf: %-6s", Phases[p]);
+        for (e = BIODIFF_EVENT_CYCLES; e <= BIODIFF_EVENT_INSTRUCTIONS; e++)
+            if (stat -> perf[p][e] < 0)
+                printf(" %14s", "n/a");
+            else
+                printf(" %14lld", stat -> perf[p][e]);
+        if (stat -> perf[p][BIODIFF_EVENT_CYCLES] > 0 && stat -> perf[p][BIODIFF_EVENT_INSTRUCTIONS] >= 0)
+            printf(" %6.2f", (double) stat -> perf[p][BIODIFF_EVENT_INSTRUCTIONS] / stat -> perf[p][BIODIFF_EVENT_CYCLES]);
         else
+            printf(" %6s", "n/a");
+        for (e = BIODIFF_EVENT_LLC_MISSES; e < BIODIFF_EVENTS; e++)
+            if (stat -> perf[p][e] < 0 || !records)
+                printf(" %14s", "n/a");
+            else
+                printf(" %14.3f", (double) stat -> perf[p][e] / records);
+        printf("\n");
+    }
+}
+
+/******************************************************************************/
+/* Print_memory: print the memory of --memory by kind, what is still held and the most
+   ever held, and the tries and radix trees built by the depth and the children of their nodes */
+void Print_memory(const Biodiff_stats *stat)
+{
+    int i, last;
+    printf("Memory: %-8s %14s %14s %12s %12s\n", "kind", "bytes now", "peak bytes", "blocks now", "peak blocks");
+    for (i = 0; i < BIODIFF_MEM_TAGS; i++)
+        printf("Memory: %-8s %14lld %14lld %12ld %12ld\n", Kinds[i], stat -> memory[i].bytes, stat -> memory[i].peak,
+               stat -> memory[i].blocks, stat -> memory[i].peak_blocks);
+    printf("Memory: %lld bytes at the peak of all kinds\n", stat -> memory_peak);
+    if (!stat -> trie_nodes)
+        return;
+    printf("Trie: %ld nodes\n", stat -> trie_nodes);
+    for (last = BIODIFF_DEPTHS - 1; last > 0 && !stat -> trie_depth[last]; last--)
+        ;
+    printf("Trie depth:");
+    for (i = 0; i <= last; i++)
+        if (stat -> trie_depth[i])
+            printf(" %d%s:%ld", i, i == BIODIFF_DEPTHS - 1 ? "+" : "", stat -> trie_depth[i]);
+    printf("\nTrie fan-out:");
+    for (i = 0; i < BIODIFF_FANOUTS; i++)
+        if (stat -> trie_fanout[i])
+            printf(" %d%s:%ld", i, i == BIODIFF_FANOUTS - 1 ? "+" : "", stat -> trie_fanout[i]);
+    printf("\n");
+}
+
+/******************************************************************************/
+/* Get_size: parse a size like 512M or 4G */
+double Get_size(char *arg)
+{
+    char *unit;
+    double size = strtod(arg, &unit);
+    switch (*unit)     /* every unit falls through to the smaller ones */
+    {
+        case 'T': case 't': size *= 1024;
+        case 'G': case 'g': size *= 1024;
+        case 'M': case 'm': size *= 1024;
+        case 'K': case 'k': size *= 1024;
+    }
+    return size;
+}
+
+/******************************************************************************/
+/* Get_cols: parse the key columns separated by ',', each maybe with its type: 3:i a number,
+   3:f a string without case, 3:s a string; col holds BIODIFF_MAX_KEY + 1, ended by 0.
+   -1 for anything else: the server takes columns from its clients and must not exit */
+int Get_cols(char *arg, int *col)
+{
+    int n = 0;
+    for (; n < BIODIFF_MAX_KEY && *arg; arg += *arg == ',')
+    {
+        col[n] = strtol(arg, &arg, 10);
+        if (*arg == ':')
         {
-            Get_col(line_A, column_A1, SEPARATORS, col_A1);
-            Get_col(line_A, column_A2, SEPARATORS, col_A2);
-            strcat(column_A1, column_A2);
-            Insert_trie(root_A, column_A1);  /* insert a string to the tire tree*/
+            if (arg[1] == 'i')
+                col[n] |= BIODIFF_KEY_INT;
+            else if (arg[1] == 'f')
+                col[n] |= BIODIFF_KEY_FOLD;
+            else if (arg[1] != 's')
+                return -1;
+            arg += 2;
         }
+        if (*arg && *arg != ',')
+            return -1;
+        n++;
     }
-    
-    while (fgets(line_B, LINE_BUFFER, fileB) != NULL)/* search and write to files A&B_B and B-A */
+    while (n <= BIODIFF_MAX_KEY)
+        col[n++] = 0;   /* the whole of it, as --state compares it */
+    return 0;
+}
+
+/******************************************************************************/
+/* Get_options: take the --options out of argv and return the number of arguments left */
+int Get_options(int argc, char *argv[])
+{
+    int i, n = 1;
+    for (i = 1; i < argc; ++i)
     {
-        if (*line_B == '\n')
-            ;   /* skip the empty lines*/
-        else
+        if (!strcmp(argv[i], "-na") && i + 1 < argc)
+        {
+            argv[n++] = argv[i];    /* the distance follows the mode */
+            if (!*argv[++i] || strspn(argv[i], "0123456789") != strlen(argv[i]))
+                Info(5);
+            Opt.lib.distance = atoi(argv[i]);
+        }
+        else if (strncmp(argv[i], "--", 2))
+            argv[n++] = argv[i];    /* keep the positional arguments in order */
+        else if (!strcmp(argv[i], "--perf"))
+            Opt.lib.perf = 1;
+        else if (!strcmp(argv[i], "--memory"))
+            Opt.memory = Opt.lib.shape = 1;
+        else if (!strcmp(argv[i], "--ignore-case"))
+            Opt.lib.fold |= BIODIFF_FOLD_CASE;
+        else if (!strcmp(argv[i], "--strip-version"))
+            Opt.lib.fold |= BIODIFF_FOLD_VERSION;
+        else if (!strcmp(argv[i], "--bloom") && i + 1 < argc)
+        {
+            Opt.lib.bloom_fpr = atof(argv[++i]);
+            if (Opt.lib.bloom_fpr <= 0 || Opt.lib.bloom_fpr >= 1)
+                Info(5);
+        }
+        else if (!strcmp(argv[i], "--mem-limit") && i + 1 < argc)
+        {
+            if ((Opt.lib.mem_limit = Get_size(argv[++i])) <= 0)
+                Info(5);
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
         {
-            Get_col(line_B, column_B1,SEPARATORS, col_B1);
-            Get_col(line_B, column_B2,SEPARATORS, col_B2);
-            strcat(column_B1, column_B2);
-            if (Search_trie1(root_A, column_B1)) /* write to file A&B_B*/
-                fprintf(fileAB_B, "%s", line_B);
+            if ((Opt.lib.threads = atoi(argv[++i])) < 1)
+                Info(5);
+        }
+        else if (!strcmp(argv[i], "--batch") && i + 1 < argc)
+        {
+            if ((Opt.lib.batch = atoi(argv[++i])) < 1 || Opt.lib.batch > 64)
+                Info(5);
+        }
+        else if (!strcmp(argv[i], "--region") && i + 1 < argc)
+            Add_region(argv[++i]);
+        else if (!strcmp(argv[i], "--regions") && i + 1 < argc)
+            Read_regions(argv[++i]);
+        else if (!strcmp(argv[i], "--sequence") && i + 1 < argc)
+        {
+            if ((Opt.sequence = atoi(argv[++i])) < 0)
+                Info(5);
+        }
+        else if (!strcmp(argv[i], "--state") && i + 1 < argc)
+            Opt.state = argv[++i];
+        else if (!strcmp(argv[i], "--cover"))
+            Opt.lib.cover = 1;
+        else if (!strcmp(argv[i], "--estimate"))
+            Opt.estimate = 1;
+        else if (!strcmp(argv[i], "--venn"))
+            Opt.venn = 1;
+        else if (!strcmp(argv[i], "--annotate"))
+            Opt.venn = Opt.annotate = 1;
+        else if (!strcmp(argv[i], "--serve") && i + 1 < argc)
+            Opt.serve = argv[++i];
+        else if (!strcmp(argv[i], "--bgzf"))
+            Opt.bgzf = 1;
+        else if (!strcmp(argv[i], "--gzi"))
+            Opt.bgzf = Opt.gzi = 1;
+        else if (!strcmp(argv[i], "--coord") && i + 1 < argc)
+        {
+            ++i;
+            if (!strcmp(argv[i], "int"))
+                Opt.lib.coord = BIODIFF_COORD_INT;
+            else if (!strcmp(argv[i], "string"))
+                Opt.lib.coord = BIODIFF_COORD_STRING;
             else
-                fprintf(fileB_A, "%s", line_B); /* write to file B-A */
-            Insert_trie(root_B, column_B1);     /* build a tire tree according to fileB*/
+                Info(5);
         }
-    }
-    free(root_A);   /* release the storage of root_A*/
-    fseek(fileA, 0, SEEK_SET);  /* move the pointer to the start of fileA*/
-    
-    while (fgets(line_A, LINE_BUFFER, fileA) != NULL)/* search and write to the files A&B_A and A-B */
-    {
-        if (*line_A == '\n')
-            ;  /* skip the empty lines*/
-        else
+        else if (!strcmp(argv[i], "--engine") && i + 1 < argc)
         {
-            Get_col(line_A, column_A1, SEPARATORS, col_A1);
-            Get_col(line_A, column_A2, SEPARATORS, col_A2);
-            strcat(column_A1, column_A2);
-            if (Search_trie1(root_B, column_A1))  /* write to file A&B_A */
-                fprintf(fileAB_A, "%s", line_A);
+            ++i;
+            if (!strcmp(argv[i], "trie"))
+                Opt.lib.engine = BIODIFF_ENGINE_TRIE;
+            else if (!strcmp(argv[i], "hash"))
+                Opt.lib.engine = BIODIFF_ENGINE_HASH;
+            else if (!strcmp(argv[i], "partition"))
+                Opt.lib.engine = BIODIFF_ENGINE_PARTITION;
             else
-                fprintf(fileA_B, "%s", line_A);  /* write to file A-B */
+                Info(5);
         }
+        else if (!strcmp(argv[i], "--huge-pages") && i + 1 < argc)
+        {
+            ++i;
+            if (!strcmp(argv[i], "thp"))
+                Opt.lib.huge_pages = BIODIFF_HUGE_THP;
+            else if (!strcmp(argv[i], "hugetlb"))
+                Opt.lib.huge_pages = BIODIFF_HUGE_TLB;
+            else
+                Info(5);
+        }
+        else if (!strcmp(argv[i], "--shards") && i + 1 < argc)
+        {
+            if ((Opt.shards = atoi(argv[++i])) < 1)
+                Info(5);
+        }
+        else if (!strcmp(argv[i], "--shard-dir") && i + 1 < argc)
+            Opt.shard_dir = argv[++i];
+        else if (!strcmp(argv[i], "--launcher") && i + 1 < argc)
+            Opt.launcher = argv[++i];
+        else if (!strcmp(argv[i], "--shard") && i + 1 < argc)   /* the options of a worker */
+        {
+            if (sscanf(argv[++i], "%d/%d", &Opt.lib.shard, &Opt.lib.shards) != 2 ||
+                Opt.lib.shard < 0 || Opt.lib.shard >= Opt.lib.shards)
+                Info(5);
+        }
+        else if (!strcmp(argv[i], "--shard-out") && i + 1 < argc)
+            Opt.shard_out = argv[++i];
+        else if (!strcmp(argv[i], "--cuts") && i + 1 < argc)
+        {
+            char *cut = argv[++i];
+            int n;
+            for (n = 1; (cut = strchr(cut, ',')); cut++)
+                n++;
+            Opt.lib.cuts = Opt.cuts = (int *) malloc(sizeof(int) * n);
+            for (n = 0, cut = argv[i]; cut; cut = strchr(cut, ',') ? strchr(cut, ',') + 1 : NULL)
+                Opt.cuts[n++] = atoi(cut);
+        }
+        else if (!strcmp(argv[i], "--numa") && i + 1 < argc)
+        {
+            if (strcmp(argv[++i], "interleave"))
+                Info(5);
+            Opt.lib.numa = BIODIFF_NUMA_INTERLEAVE;
+        }
+        else
+            Info(5);
     }
-    free(root_B);   /* release the storage of root_B*/
+    return n;
+}
+/******************************************************************************/
+/* Get_mode: the number of a mode in Modes, -1 for none */
+int Get_mode(char *arg)
+{
+    for (int i = 0; i < MODES; i++)
+        if (!strcmp(arg, Modes[i]))
+            return i;
+    return -1;
 }
 
 /******************************************************************************/
-/* c_overlap: coordinated-based overlap differences*/
-void c_overlap(char *col_A, char *col_B,char *file_A, char *file_B,
-               FILE *fileA, FILE *fileB, FILE *fileAB_A, FILE *fileAB_B,
-               FILE *fileA_B, FILE *fileB_A)
-{
-    int row_A = Get_row(file_A);         /* get the number of rows of fileA*/
-    int row_B = Get_row(file_B);         /* get the number of rows of fileB*/
-    char colA1s[4], colA2s[4], colB1s[4], colB2s[4];
-    Get_col(col_A, colA1s, ',', 1);      /* get the column number from command line arguements */
-    Get_col(col_A, colA2s, ',', 2);
-    Get_col(col_A, colB1s, ',', 1);
-    Get_col(col_B, colB2s, ',', 2);
-    int col_A1 = atoi(colA1s);           /* transfer string to int */
-    int col_A2 = atoi(colA2s);
-    int col_B1 = atoi(colB1s);
-    int col_B2 = atoi(colB2s);
-    int *index_A = index_(row_A);        /* create index */
-    int *index_B = index_(row_B);
-    int *advector_A = advector(row_A);   /* create adjoint vector*/
-    int *advector_B = advector(row_B);
-    Columns_A = (char***)malloc(sizeof(char**) * 3);  /* allocal space */
-    Columns_B = (char***)malloc(sizeof(char**) * 3);
-    char **lines_A;
-    char **lines_B;
-    Columns_A[1] = store_col(row_A, file_A, col_A1);  /* get and store the specific columnn from a file */
-    Columns_A[2] = store_col(row_A, file_A, col_A2);
-    Columns_B[1] = store_col(row_B, file_B, col_B1);
-    Columns_B[2] = store_col(row_B, file_B, col_B2);
-    
-    qsort(index_A + 1, row_A, sizeof(index_A[1]), cmp_A);/* qsort the index according to the left end point*/
-    qsort(index_B + 1, row_B, sizeof(index_B[1]), cmp_B);
-    
-    int i, j, temp;
-    /* judge whether the coordinate is overlap and mark in the adjoint vector. */
-    for(i=1, j=1; i <= row_A; ++i) /* mark on advector when B's left end point is between A's left & right end point.*/
-    {
-        for(; j <= row_B; ++j)
+/* Convert: convert an input file into a columnar file that every mode reads without parsing */
+void Convert(char *source, char *target)
+{
+    Biodiff *bd = Biodiff_create(&Opt.lib);
+    if (Biodiff_convert(bd, source, target))
+        Error(bd);
+    Biodiff_free(bd);
+    printf("Complete!\n");
+    exit(0);
+}
+
+/******************************************************************************/
+/* Index: build the binned index of an input file for --region */
+void Index(char *file_name, char *cols)
+{
+    Biodiff *bd = Biodiff_create(&Opt.lib);
+    int col[BIODIFF_MAX_KEY + 1];
+    if (Get_cols(cols, col))
+        Info(5);
+    if (col[0] < 1 || col[1] < 1)
+        Info(1);
+    if (Biodiff_index(bd, file_name, Opt.sequence, col))
+        Error(bd);
+    Biodiff_free(bd);
+    printf("Complete!\n");
+    exit(0);
+}
+
+/******************************************************************************/
+/* Sketch: sketch the keys of an input file in the columns for --estimate */
+void Sketch(char *file_name, char *cols, char *target)
+{
+    Biodiff *bd = Biodiff_create(&Opt.lib);
+    Biodiff_table *table;
+    Biodiff_sketch sketch;
+    int col[BIODIFF_MAX_KEY + 1];
+    if (Get_cols(cols, col))
+        Info(5);
+    if (!(table = Biodiff_table_file(bd, file_name, col)) || Biodiff_sketch_table(bd, table, &sketch) ||
+        Biodiff_sketch_save(bd, &sketch, target))
+        Error(bd);
+    Biodiff_table_free(table);
+    Biodiff_free(bd);
+    printf("Complete!\n");
+    exit(0);
+}
+
+/* Sketch_file: the sketch of an input file, read from it when its name ends with SKETCH_SUFFIX,
+   which must be of the same key columns */
+void Sketch_file(Biodiff *bd, char *file_name, int *col, Biodiff_sketch *sketch)
+{
+    Biodiff_table *table;
+    size_t len = strlen(file_name);
+    if (len > strlen(SKETCH_SUFFIX) && !strcmp(file_name + len - strlen(SKETCH_SUFFIX), SKETCH_SUFFIX))
+    {
+        if (Biodiff_sketch_load(bd, file_name, sketch))
+            Error(bd);
+        for (int i = 0; i < BIODIFF_MAX_KEY; i++)
+            if ((sketch -> col[i] | sketch -> type[i]) != col[i])
+            {
+                printf("Error: the sketch %s is of other key columns than given.\n", file_name);
+                exit(1);
+            }
+        return;
+    }
+    if (!(table = Biodiff_table_file(bd, file_name, col)) || Biodiff_sketch_table(bd, table, sketch))
+        Error(bd);
+    Biodiff_table_free(table);
+}
+
+/* Estimate: print the distinct keys of each file and of both, and their Jaccard index, with the
+   bounds of two standard errors; nothing is compared and no result is written */
+void Estimate(int mode, int *col_A, int *col_B, char *name_A, char *name_B)
+{
+    Biodiff *bd;
+    Biodiff_sketch *A, *B;
+    Biodiff_similarity e;
+    clock_t start = clock(), end;
+    if (mode != BIODIFF_EQUAL)
+    {
+        printf("Error: --estimate takes the keys of [-ce] or [-ne].\n");
+        exit(1);
+    }
+    bd = Biodiff_create(&Opt.lib);
+    A = (Biodiff_sketch *) malloc(sizeof(Biodiff_sketch));
+    B = (Biodiff_sketch *) malloc(sizeof(Biodiff_sketch));
+    Sketch_file(bd, name_A, col_A, A);
+    Sketch_file(bd, name_B, col_B, B);
+    if (Biodiff_estimate(bd, A, B, &e))
+        Error(bd);
+    end = clock();
+    printf("%lu min %lu s %lu ms\n", (end - start) / (60 * CLOCKS_PER_SEC), (end - start) % (60 * CLOCKS_PER_SEC) / CLOCKS_PER_SEC, (end - start) % (60 * CLOCKS_PER_SEC) % CLOCKS_PER_SEC * 1000 / CLOCKS_PER_SEC);
+    printf("Estimate: distinct keys within 2 standard errors\n");
+    printf("  fileA   %.0f +- %.0f of %lld rows\n", e.a, 2 * e.a_error, A -> rows);
+    printf("  fileB   %.0f +- %.0f of %lld rows\n", e.b, 2 * e.b_error, B -> rows);
+    printf("  both    %.0f +- %.0f\n", e.both, 2 * e.both_error);
+    printf("  Jaccard %.4f +- %.4f\n", e.jaccard, 2 * e.jaccard_error);
+    free(A);
+    free(B);
+    Biodiff_free(bd);
+    exit(0);
+}
+
+/******************************************************************************/
+/* Add_region: add a region given as name:start-end, or start-end for any sequence */
+void Add_region(char *arg)
+{
+    Biodiff_region *region;
+    char *span = strrchr(arg, ':'), *end;
+    Opt.region = (Biodiff_region *) realloc(Opt.region, sizeof(Biodiff_region) * (Opt.regions + 1));
+    region = Opt.region + Opt.regions++;
+    region -> name = NULL;
+    if (span)
+    {
+        region -> name = strndup(arg, span - arg);
+        arg = span + 1;
+    }
+    region -> start = strtol(arg, &end, 10);
+    if (end == arg || *end != '-')
+        Info(5);
+    region -> end = strtol(arg = end + 1, &end, 10);
+    if (end == arg || *end || region -> end < region -> start)
+        Info(5);
+}
+
+/******************************************************************************/
+/* Read_regions: add the regions of a BED file, name start end on every line;
+   empty lines and lines of comments are skipped */
+void Read_regions(char *file_name)
+{
+    FILE *bed = fopen(file_name, "r");
+    char line[REQUEST_SIZE], region[2 * REQUEST_SIZE], name[REQUEST_SIZE];
+    long start, end;
+    if (!bed)
+    {
+        printf("Error: Can not open the regions file %s.\n", file_name);
+        exit(1);
+    }
+    while (fgets(line, sizeof(line), bed))
+    {
+        if (*line == '#' || *line == '\n' || !strncmp(line, "track", 5) || !strncmp(line, "browser", 7))
+            continue;
+        if (sscanf(line, "%s %ld %ld", name, &start, &end) != 3)
         {
-            /* skip extra B when B's left end point is smaller than A' left end point */
-            if (atoi(Columns_A[1][index_A[i]]) > atoi(Columns_B[1][index_B[j]])) continue;
-            else
-                for(temp = j; temp<row_B; ++temp) /* search for target B and mark both A and B */
-                {
-                    /* break when B's left end point is biger than A's right point */
-                    if(atoi(Columns_A[2][index_A[i]]) < atoi(Columns_B[1][index_B[temp]]))
-                        break;
-                    else
-                        advector_A[index_A[i]] = advector_B[index_B[temp]] = EXIST; /* mark on both A&B's advector*/
-                }
-            break;
+            printf("Error: Can not read the region '%s' of %s.\n", strtok(line, "\n"), file_name);
+            exit(1);
         }
+        sprintf(region, "%s:%ld-%ld", name, start, end);
+        Add_region(region);
+    }
+    fclose(bed);
+}
+
+/******************************************************************************/
+/* Incremental: compare only the records appended to fileB since the last run of a --state file.
+   Every match is between a row of fileA and a row of fileB, so comparing fileA with the new rows
+   of fileB finds every new match: the rows of fileB are added to their results, the rows of
+   fileA matched now join those matched before and their results are written again. */
+void Incremental(int mode, int *col_A, int *col_B, char *name_A, char *name_B)
+{
+    Biodiff *bd;
+    Biodiff_table *fileA, *fileB;
+    Biodiff_writer *target[4];   /* as in Targets: by side, then by mark */
+    Biodiff_result result = {{NULL, NULL}, {0, 0}, Emit_state, target};
+    struct stat st;
+    FILE *file;
+    char *data, name[REQUEST_SIZE];
+    size_t len;
+    long long mtime, i;
+    int fresh;
+    if (Opt.bgzf)
+    {
+        printf("Error: --state adds to plain results, it does not write BGZF.\n");
+        exit(1);
+    }
+    if (mode == BIODIFF_OVERLAP)
+    {
+        printf("Error: --state compares [-ce], [-ne], [-no] and [-na], not [-co].\n");
+        exit(1);
+    }
+    if (stat(name_A, &st))
+    {
+        printf("Error: Can not open the input file %s.\n", name_A);
+        exit(1);
     }
-    for(i=1, j=1; j <= row_B; ++j)/* mark on advector when A's left end point is between B's left & right end point.*/
+    mtime = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    if ((fresh = !(file = fopen(Opt.state, "rb"))))
     {
-        for(; i <= row_A; ++i)
+        memcpy(State.magic, STATE_MAGIC, 8);
+        State.mode = mode;
+        memcpy(State.col_A, col_A, sizeof(State.col_A));
+        memcpy(State.col_B, col_B, sizeof(State.col_B));
+        State.size_A = st.st_size;
+        State.mtime_A = mtime;
+    }
+    else
+    {
+        if (fread(&State, sizeof(State), 1, file) != 1 || memcmp(State.magic, STATE_MAGIC, 8) || State.rows_A < 0 ||
+            fread(State_matched = (unsigned char *) calloc(State.rows_A / 8 + 1, 1), 1, State.rows_A / 8 + 1, file) != (size_t) State.rows_A / 8 + 1)
         {
-            /* skip extra A when A's left end point is smaller than B' left end point */
-            if (atoi(Columns_B[1][index_B[j]]) > atoi(Columns_A[1][index_A[i]])) continue;
-            else
-                for(temp = i; temp<row_A; ++temp) /* search for target B and mark both A and B */
-                {
-                    /* break when A's left end point is biger than B's right point */
-                    if(atoi(Columns_B[2][index_B[j]]) < atoi(Columns_A[1][index_A[temp]]))
-                        break;
-                    else
-                        advector_A[index_A[temp]] = advector_B[index_B[j]] = EXIST; /* mark on both A&B's advector*/
-                }
-            break;
+            printf("Error: The state file %s is damaged.\n", Opt.state);
+            exit(1);
+        }
+        fclose(file);
+        if (State.mode != mode || memcmp(State.col_A, col_A, sizeof(State.col_A)) || memcmp(State.col_B, col_B, sizeof(State.col_B)) ||
+            State.size_A != st.st_size || State.mtime_A != mtime)
+        {
+            printf("Error: The state file %s was made for another fileA, mode or columns; remove it to start again.\n", Opt.state);
+            exit(1);
         }
     }
-    /* print every line to target files according to the index and adjoint vector.*/
-    char line[LINE_BUFFER];
-    for (i = 1; i <= row_A; ++i)
+
+    bd = Biodiff_create(&Opt.lib);
+    Biodiff_set_log(bd, Log, NULL);
+    if (!(data = Biodiff_load_from(bd, name_B, State.offset_B, &len)))
+        Error(bd);
+    if (!fresh && !len)
     {
-        fgets(line, LINE_BUFFER, fileA);
-        if (advector_A[i])
-            fprintf(fileAB_A, "%s", line);
-        else
-            fprintf(fileA_B,  "%s", line);
+        printf("Nothing was appended to %s since byte %lld.\n", name_B, State.offset_B);
+        exit(0);
     }
-    for (i = 1; i <=row_B; ++i)
+    if (!(fileA = Biodiff_table_file(bd, name_A, col_A)))
+        Error(bd);
+    if (!(fileB = Biodiff_table_buffer(bd, data, len, col_B)))
+        Error(bd);
+    for (i = 0; i < 4; i++)   /* the results of fileB grow once there are some */
+        if (!(target[i] = i < 2 || fresh ? Biodiff_writer_open(bd, Targets[i], 0, 0) : Biodiff_writer_append(bd, Targets[i])))
+            Error(bd);
+
+    clock_t start = clock();
+    if (Biodiff_compare(bd, mode, fileA, fileB, &result))
+        Error(bd);
+    clock_t end = clock();
+    printf("%lu min %lu s %lu ms\n", (end - start) / (60 * CLOCKS_PER_SEC), (end - start) % (60 * CLOCKS_PER_SEC) / CLOCKS_PER_SEC, (end - start) % (60 * CLOCKS_PER_SEC) % CLOCKS_PER_SEC * 1000 / CLOCKS_PER_SEC);
+    for (i = 0; i < 4; i++)
+        if (Biodiff_writer_close(target[i]))
+            Error(bd);
+
+    /* the rows of fileA matched in any run, and where fileB goes on next time */
+    if (!fresh && result.rows[0] != State.rows_A)
     {
-        fgets(line, LINE_BUFFER, fileB);
-        if (advector_B[i])
-            fprintf(fileAB_B, "%s", line);
-        else
-            fprintf(fileB_A,  "%s", line);
-    }
-    
-    /* close files and free the space */
-    fclose(fileA);
-    fclose(fileB);
-    fclose(fileA_B);
-    fclose(fileB_A);
-    fclose(fileAB_A);
-    fclose(fileAB_B);
-    
-    /* free the space of dynamic variables */
-    for (i = 1; i < 3; ++i) {
-        for (j = 1; j < row_A + 1; ++j) {
-            free(Columns_A[i][j]);
-        }
-        free(Columns_A[i]);
+        printf("Error: %s has %ld rows, the state file says %lld.\n", name_A, result.rows[0], State.rows_A);
+        exit(1);
     }
-    free(Columns_A);
-    
-    for (i = 1; i < 3; ++i) {
-        for (j = 1; j < row_B + 1; ++j) {
-            free(Columns_B[i][j]);
-        }
-        free(Columns_B[i]);
+    for (i = 0; i <= State.rows_A / 8 && State_matched; i++)
+        result.matched[0][i] |= State_matched[i];
+    State.rows_A = result.rows[0];
+    State.rows_B += result.rows[1];
+    State.offset_B += len;
+    snprintf(name, sizeof(name), "%s.tmp", Opt.state);
+    if (!(file = fopen(name, "wb")) || fwrite(&State, sizeof(State), 1, file) != 1 ||
+        fwrite(result.matched[0] ? result.matched[0] : (unsigned char *) "", 1, result.matched[0] ? State.rows_A / 8 + 1 : 1, file) != (size_t) (result.matched[0] ? State.rows_A / 8 + 1 : 1) ||
+        fclose(file) || rename(name, Opt.state))
+    {
+        printf("Error: Can not write the state file %s.\n", Opt.state);
+        exit(1);
     }
-    free(Columns_B);
-    
+    printf("%ld new rows of %s compared, %lld bytes and %lld rows in all\n", result.rows[1], name_B, State.offset_B, State.rows_B);
+
+    Biodiff_result_free(&result);
+    Biodiff_table_free(fileA);
+    Biodiff_table_free(fileB);
+    if (Opt.memory)
+        Print_memory(Biodiff_get_stats(bd));
+    Biodiff_free(bd);
+    free(data);
+    free(State_matched);
+    printf("Complete!\n");
+    exit(0);
 }
 
+/******************************************************************************/
+/* Emit_state: write a row of --state, a row of fileA as matched when it was in an earlier run */
+void Emit_state(void *arg, int side, long row, int matched, const char *record)
+{
+    if (!side && State_matched && row < State.rows_A && State_matched[row >> 3] >> (row & 7) & 1)
+        matched = 1;
+    Emit(arg, side, row, matched, record);
+}
 
 /******************************************************************************/
-/* n_diff: name-based equivalent & overlap differences */
-void n_diff(int col_A, int col_B,
-           FILE *fileA, FILE *fileB, FILE *fileAB_A,
-           FILE *fileAB_B, FILE *fileA_B, FILE *fileB_A, int mode)
-{
-    char line_A[LINE_BUFFER];
-    char line_B[LINE_BUFFER];
-    char columnA[COLUMN_SIZE];
-    char columnB[COLUMN_SIZE];
-    TrieNode *root_A = Create_tire();
-    TrieNode *root_B = Create_tire();
-    /* bulid a tire tree according to fileA */
-    while (fgets(line_A, LINE_BUFFER, fileA) != NULL)
-    {
-        if (*line_A == '\n')
-            ;   /* skip the empty lines*/
-        else
+/* Shards: compare in worker processes, a shard each, and merge their bitmaps into the result.
+   A worker is this program again, with the arguments as given and the shard to compare; it
+   reads the input files itself and leaves only the bitmaps of the rows it matched in the
+   shard directory. The bitmaps OR'ed together are passed to the result in the order of the rows */
+int Shards(Biodiff *bd, int mode, Biodiff_table *fileA, Biodiff_table *fileB, Biodiff_result *result)
+{
+    Biodiff_table *table[2] = {fileA, fileB};
+    struct Shard_header header;
+    struct timespec begin, end;
+    unsigned char *matched[2] = {NULL, NULL}, *bits;
+    char dir[REQUEST_SIZE], name[REQUEST_SIZE + 32], shard[32], *cuts = NULL, **args;
+    long long rows[2] = {-1, -1}, k;
+    int *cut, made = !Opt.shard_dir, failed = 0, status, i, j, n;
+    pid_t *pid;
+    FILE *file;
+    if (mode == BIODIFF_OVERLAP)   /* the coordinates are split where the rows are about even */
+    {
+        cut = (int *) malloc(sizeof(int) * Opt.shards);
+        if ((status = Biodiff_shard_cuts(bd, table, 2, Opt.shards, cut)) == BIODIFF_UNSPLIT)
         {
-            Get_col(line_A, columnA, SEPARATORS, col_A);
-            Insert_trie(root_A, columnA); /* insert a string into the tire tree */
+            printf("Shards: the coordinates do not sort as strings the way they do as numbers, compared in one process\n");
+            free(cut);
+            return Biodiff_compare(bd, mode, fileA, fileB, result);
         }
+        if (status)
+            return BIODIFF_ERROR;
+        cuts = (char *) malloc(12 * Opt.shards + 1);
+        for (*cuts = 0, i = 0; i < Opt.shards - 1; i++)
+            sprintf(cuts + strlen(cuts), i ? ",%d" : "%d", cut[i]);
+        free(cut);
     }
-    /* search and write to the files A&B_A and A-B */
-    while (fgets(line_B, LINE_BUFFER, fileB) != NULL)
+    if (made)
     {
-        if(*line_B == '\n')
-            ;   /* skip the empty lines */
-        else
+        snprintf(dir, sizeof(dir), "%s/biodiff-shards-XXXXXX", getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp");
+        if (!mkdtemp(dir))
         {
-            Get_col(line_B, columnB, SEPARATORS, col_B);
-            if(mode==1?Search_trie1(root_A, columnB):Search_trie2(root_A,columnB))  /* write to file A&B_B*/
-                fprintf(fileAB_B,"%s", line_B);
-            else
-                fprintf(fileB_A, "%s", line_B);     /* write to file B-A */
-            Insert_trie(root_B, columnB);        /* build a tire tree according to fileB*/
+            printf("Error: Can not create the shard directory %s.\n", dir);
+            exit(1);
         }
     }
-    free(root_A);     /* release the storage of root_A*/
-    fseek(fileA, 0, SEEK_SET);      /* move the pointer to the start of fileA*/
-    
-    /* search and write to the files A&B_A and A-B */
-    while (fgets(line_A, LINE_BUFFER, fileA) != NULL)
-    {
-        if (*line_A == '\n')
-            ;    /* skip the empty lines*/
+    else
+        snprintf(dir, sizeof(dir), "%s", Opt.shard_dir);
 
+    /* the arguments of a worker: its shard first, then the arguments as given but --shards */
+    args = (char **) malloc(sizeof(char *) * (Opt.argn + 8));
+    args[0] = Opt.args[0];
+    args[1] = "--shard";
+    args[2] = shard;
+    args[3] = "--shard-out";
+    args[4] = name;
+    n = 5;
+    if (cuts && Opt.shards > 1)
+    {
+        args[n++] = "--cuts";
+        args[n++] = cuts;
+    }
+    for (i = 1; i < Opt.argn; i++)
+        if (!strcmp(Opt.args[i], "--shards") || !strcmp(Opt.args[i], "--shard-dir") || !strcmp(Opt.args[i], "--launcher"))
+            i++;
         else
+            args[n++] = Opt.args[i];
+    args[n] = NULL;
+    pid = (pid_t *) malloc(sizeof(pid_t) * Opt.shards);
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (i = 0; i < Opt.shards; i++)
+    {
+        snprintf(shard, sizeof(shard), "%d/%d", i, Opt.shards);
+        snprintf(name, sizeof(name), "%s/shard.%d", dir, i);
+        unlink(name);   /* left by an earlier run */
+        if ((pid[i] = Launch(i, args)) < 0)
+            failed = 1;
+    }
+    for (i = 0; i < Opt.shards; i++)
+        if (pid[i] > 0 && (waitpid(pid[i], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status)))
+            failed = 1;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    /* OR the bitmaps of the shards together */
+    for (i = 0; !failed && i < Opt.shards; i++)
+    {
+        snprintf(name, sizeof(name), "%s/shard.%d", dir, i);
+        if (!(file = fopen(name, "rb")) || fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, SHARD_MAGIC, 8) ||
+            header.shard != i || header.shards != Opt.shards || (i && (header.rows[0] != rows[0] || header.rows[1] != rows[1])))
+            failed = 1;
+        for (j = 0; !failed && j < 2; j++)
         {
-            Get_col(line_A, columnA, SEPARATORS, col_A);
-            if ( mode==1?Search_trie1(root_B, columnA):Search_trie2(root_B,columnA))    /* write to file A&B_A */
-                fprintf(fileAB_A, "%s", line_A);
-            else
-                fprintf(fileA_B, "%s", line_A);   /* write to file A-B */
+            if (!i)
+            {
+                rows[j] = header.rows[j];
+                matched[j] = (unsigned char *) calloc((rows[j] + 7) / 8 + 1, 1);
+            }
+            bits = (unsigned char *) malloc((rows[j] + 7) / 8 + 1);
+            if (fread(bits, 1, (rows[j] + 7) / 8, file) != (size_t) (rows[j] + 7) / 8)
+                failed = 1;
+            for (k = 0; k < (rows[j] + 7) / 8; k++)
+                matched[j][k] |= bits[k];
+            free(bits);
         }
+        if (file)
+            fclose(file);
+        unlink(name);
+    }
+    if (made)
+        rmdir(dir);
+    if (failed)
+    {
+        printf("Error: A worker of --shards failed or left no bitmaps in %s.\n", dir);
+        exit(1);
+    }
+    printf("Shards: %d workers in %lld ms\n", Opt.shards,
+           (long long) (end.tv_sec - begin.tv_sec) * 1000 + (end.tv_nsec - begin.tv_nsec) / 1000000);
+    status = Biodiff_pass(bd, fileA, 0, matched[0], result) || Biodiff_pass(bd, fileB, 1, matched[1], result) ? BIODIFF_ERROR : BIODIFF_OK;
+    if (!status && (result -> rows[0] != rows[0] || result -> rows[1] != rows[1]))
+    {
+        printf("Error: The input files changed while the workers of --shards read them.\n");
+        exit(1);
     }
-    free(root_B);   /* release the storage of root_B*/
+    free(matched[0]);
+    free(matched[1]);
+    free(args);
+    free(pid);
+    free(cuts);
+    return status;
 }
 
-
 /******************************************************************************/
-/* Get_col: get a specific column from a line with separators according to c */
-char *Get_col(char *line, char *col, char separator, int c)
+/* Launch: start the worker of a shard. Here it is this program again; with --launcher
+   the command and the arguments of the worker, quoted, run in the shell, which knows the
+   number of the shard as $BIODIFF_SHARD */
+pid_t Launch(int shard, char **args)
 {
-    int count = 1; /* To count the occurrences of separators.*/
-    if (c < 1)
-    return NULL;
-    while (*line != '\0' && *line == separator )
-    line++;    /* To skip the separators at the beginning of the line.*/
-    while (*line != '\0' && count < c)
+    char exe[REQUEST_SIZE], number[16], *command, *c;
+    ssize_t len;
+    size_t size;
+    pid_t pid;
+    int i;
+    if ((len = readlink("/proc/self/exe", exe, sizeof(exe) - 1)) > 0)
+        exe[len] = 0;
+    else
+        snprintf(exe, sizeof(exe), "%s", args[0]);
+    fflush(stdout);   /* or the child writes it again */
+    if ((pid = fork()))
+        return pid;
+    args[0] = exe;
+    if (!Opt.launcher)
+        execv(exe, args);
+    else
     {
-        if (*line == separator)
+        for (size = strlen(Opt.launcher) + 1, i = 0; args[i]; i++)
+            size += 4 * strlen(args[i]) + 3;
+        command = c = (char *) malloc(size);
+        c += sprintf(c, "%s", Opt.launcher);
+        for (i = 0; args[i]; i++)   /* every argument in single quotes, a quote in it as '\'' */
         {
-            while (*line != '\0' && *line == separator)
-            line++;        /* many separators are put together.*/
-            count++;
+            *c++ = ' ', *c++ = '\'';
+            for (char *a = args[i]; *a; a++)
+                c += *a == '\'' ? sprintf(c, "'\\''") : sprintf(c, "%c", *a);
+            *c++ = '\'';
         }
-        else
-        line++;
+        *c = 0;
+        snprintf(number, sizeof(number), "%d", shard);
+        setenv("BIODIFF_SHARD", number, 1);
+        execl("/bin/sh", "sh", "-c", command, (char *) NULL);
     }
-    while (*line != '\0' && *line != '\n' && *line != separator) /* get specific column */
-       *col++ = *line++;
-    *col = 0;
-    return col;
-    
+    _exit(127);
 }
 
+/******************************************************************************/
+/* Shard_worker: compare one shard and leave its bitmaps for the coordinator, under
+   a temporary name first so that a coordinator on another node sees them whole */
+void Shard_worker(Biodiff *bd, int mode, Biodiff_table *fileA, Biodiff_table *fileB)
+{
+    Biodiff_result result = {{NULL, NULL}, {0, 0}, NULL, NULL};
+    struct Shard_header header;
+    char name[REQUEST_SIZE];
+    FILE *file;
+    int j, ok;
+    if (Biodiff_compare(bd, mode, fileA, fileB, &result))
+        Error(bd);
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SHARD_MAGIC, 8);
+    header.shard = Opt.lib.shard;
+    header.shards = Opt.lib.shards;
+    header.rows[0] = result.rows[0];
+    header.rows[1] = result.rows[1];
+    snprintf(name, sizeof(name), "%s.tmp", Opt.shard_out);
+    ok = (file = fopen(name, "wb")) && fwrite(&header, sizeof(header), 1, file) == 1;
+    for (j = 0; ok && j < 2; j++)
+        ok = fwrite(result.matched[j], 1, (result.rows[j] + 7) / 8, file) == (size_t) (result.rows[j] + 7) / 8;
+    if (file && fclose(file))
+        ok = 0;
+    if (!ok || rename(name, Opt.shard_out))
+    {
+        printf("Error: Can not write the bitmaps %s.\n", Opt.shard_out);
+        exit(1);
+    }
+    Biodiff_result_free(&result);
+    Biodiff_table_free(fileA);
+    Biodiff_table_free(fileB);
+    Biodiff_free(bd);
+    exit(0);
+}
 
 /******************************************************************************/
-/*Get_row: to get the number of rows from a specific file. */
-int Get_row(char *file_name)
+/* Venn: compare many files at once and write their records by the files holding a match.
+   The result files of the patterns are created as their first records come. */
+void Venn(int argc, char *argv[])
 {
-    FILE *file = fopen(file_name, "r");
-    char line[LINE_BUFFER];
-    int i;
-    for (i = 0; fgets(line, LINE_BUFFER, file); ++i)
+    Biodiff *bd;
+    Biodiff_table *table[MAX_VENN];
+    Biodiff_writer *annotated = NULL;
+    Biodiff_venn venn;
+    char pattern[MAX_VENN + 1];
+    int col[MAX_VENN][BIODIFF_MAX_KEY + 1], cols, mode, i, n;
+    uint64_t m;
+    if ((mode = argc < 2 ? -1 : Get_mode(argv[1])) < 0)
+        Info(4);     /* usage error */
+    for (i = 2, cols = 0; i + 1 < argc && cols < MAX_VENN && (!strcmp(argv[i], "-a") || !strcmp(argv[i], "-b")); i += 2, cols++)
+        if (Get_cols(argv[i + 1], col[cols]))
+            Info(5);
+    if (!cols || (n = argc - i) < 2)
+        Info(1);     /* usage error */
+    if (n > MAX_VENN)
+    {
+        printf("Error: At most %d files are compared at once.\n", MAX_VENN);
+        exit(1);
+    }
+
+    bd = Biodiff_create(&Opt.lib);
+    Biodiff_set_log(bd, Log, NULL);
+    for (n = 0; i < argc; i++, n++)   /* the last columns given hold for the files after them */
+        if (!(table[n] = Biodiff_table_file(bd, argv[i], col[n < cols ? n : cols - 1])))
+            Error(bd);
+    Venn_files = n;
+    Venn_rows = (long *) calloc((size_t) 1 << n, sizeof(long));
+    memset(&venn, 0, sizeof(venn));
+    if (Opt.annotate)
+    {
+        if (!(annotated = Biodiff_writer_open(bd, "Venn", Opt.bgzf, Opt.gzi)))
+            Error(bd);
+        venn.emit = Annotate;
+        venn.arg = annotated;
+    }
+    else
     {
-        if (!strcmp(line, "\n")) --i; /* skip empty lines */
+        Venn_target = (Biodiff_writer **) calloc(((size_t) 1 << n) * n, sizeof(Biodiff_writer *));
+        venn.emit = Partition;
+        venn.arg = bd;
     }
-    fclose(file);
-    return i;
+
+    clock_t start = clock();
+    if (Biodiff_compare_n(bd, Compare[mode], table, n, &venn))
+        Error(bd);
+    clock_t end = clock();
+    printf("%lu min %lu s %lu ms\n", (end - start) / (60 * CLOCKS_PER_SEC), (end - start) % (60 * CLOCKS_PER_SEC) / CLOCKS_PER_SEC, (end - start) % (60 * CLOCKS_PER_SEC) % CLOCKS_PER_SEC * 1000 / CLOCKS_PER_SEC);
+    for (m = 1; m < (uint64_t) 1 << n; m++)   /* rows of every file by pattern */
+        if (Venn_rows[m])
+            printf("%s\t%ld\n", Get_pattern(m, pattern), Venn_rows[m]);
+    for (i = 0, m = 0; Opt.lib.perf && i < n; i++)
+        m += venn.rows[i];
+    if (Opt.lib.perf)
+        Print_perf(Biodiff_get_stats(bd), (long) m);
+
+    Biodiff_venn_free(&venn);
+    for (i = 0; i < n; i++)
+        Biodiff_table_free(table[i]);
+    if (annotated && Biodiff_writer_close(annotated))
+        Error(bd);
+    for (m = 0; !annotated && m < ((uint64_t) 1 << n) * n; m++)
+        if (Venn_target[m] && Biodiff_writer_close(Venn_target[m]))
+            Error(bd);
+    if (Opt.memory)
+        Print_memory(Biodiff_get_stats(bd));
+    Biodiff_free(bd);
+    printf("Complete!\n");
+    exit(0);
 }
 
 /******************************************************************************/
-/* index_: creat index from 1 to row. */
-int *index_(int row)
+/* Partition: write a row of --venn to the result file of its file and its pattern */
+void Partition(void *arg, int table, long row, uint64_t member, const char *record)
 {
-    int *temp = (int *)malloc(sizeof(int)*(row + 1));
-    for(int i = 1; i <= row; ++i) temp[i] = i;
-    return temp;
+    Biodiff_writer **target = Venn_target + member * Venn_files + table;
+    char pattern[MAX_VENN + 1], name[2 * MAX_VENN + 16];
+    if (!*target)
+    {
+        sprintf(name, "Venn_%s_%d", Get_pattern(member, pattern), table + 1);
+        if (!(*target = Biodiff_writer_open((Biodiff *) arg, name, Opt.bgzf, Opt.gzi)))
+            Error((Biodiff *) arg);
+    }
+    Biodiff_write(*target, record);
+    Venn_rows[member]++;
 }
 
 /******************************************************************************/
-/*advector: create an adjoint vector for the whole file to mark whether a row is overlap.*/
-int *advector(int row)
+/* Annotate: write a row of --venn to one result file, tagged with its file and its pattern */
+void Annotate(void *arg, int table, long row, uint64_t member, const char *record)
 {
-    int *temp = (int *)malloc(sizeof(int)*(row + 1));
-    for(int i = 1; i <= row; ++i) temp[i] = NOTEXIST;
-    return temp;
+    char pattern[MAX_VENN + 1], line[REQUEST_SIZE];
+    snprintf(line, sizeof(line), "%d\t%s\t%s", table + 1, Get_pattern(member, pattern), record);
+    Biodiff_write((Biodiff_writer *) arg, line);
+    Venn_rows[member]++;
 }
 
 /******************************************************************************/
-/*store_col: get and store the specific column from a file.*/
-char** store_col(int row, char *file_name, int column)
+/* Get_pattern: the pattern of a word of files, '1' for a file holding a match and '0' for another */
+char *Get_pattern(uint64_t member, char *pattern)
 {
-    FILE *file = fopen(file_name, "r");
-    char line[LINE_BUFFER];
-    char col[COLUMN_SIZE];
-    int i, j, k, l;
-    char **columns = (char**)malloc(sizeof(char*) * (row + 1));  /* allocal space for pointer */
-    for (l = 1; fgets(line, LINE_BUFFER, file); ++l)
+    int i;
+    for (i = 0; i < Venn_files; i++)
+        pattern[i] = member >> i & 1 ? '1' : '0';
+    pattern[i] = 0;
+    return pattern;
+}
+
+/******************************************************************************/
+/* Serve: keep the references in memory and answer requests on a Unix socket.
+   Every reference is loaded once with the indices of the modes given before it;
+   the prepared tables are only read afterwards, so the threads share them. */
+void Serve(int argc, char *argv[])
+{
+    Biodiff *bd;
+    struct Reference *ref;
+    struct sockaddr_un addr;
+    pthread_t *thread;
+    int col[MODES][BIODIFF_MAX_KEY + 1], loaded[MODES] = {0}, threads, i, m;
+    for (i = 1; i + 2 < argc && (m = Get_mode(argv[i])) >= 0; i += 3)
+    {
+        if (strcmp(argv[i + 1], "-a"))
+            Info(1);
+        if (Get_cols(argv[i + 2], col[m]))
+            Info(5);
+        loaded[m] = 1;
+    }
+    if (i == 1 || i == argc || argc - i > MAX_REFERENCES)
+        Info(1);     /* usage error */
+    bd = Biodiff_create(&Opt.lib);
+    Biodiff_set_log(bd, Log, NULL);
+    for (; i < argc; i++)
+    {
+        ref = References + References_n++;
+        ref -> name = argv[i];
+        if (!(ref -> data = Biodiff_load(bd, argv[i], &ref -> len)))
+            Error(bd);
+        for (m = 0; m < MODES; m++)
+            if (loaded[m])
+            {
+                if (!(ref -> table[m] = Biodiff_table_buffer(bd, ref -> data, ref -> len, col[m])) ||
+                    Biodiff_table_prepare(bd, ref -> table[m], Compare[m]))
+                    Error(bd);
+            }
+        printf("Loaded %s: %lu bytes\n", argv[i], (unsigned long) ref -> len);
+    }
+
+    /* listen on the socket, a stale one is replaced */
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(Opt.serve) >= sizeof(addr.sun_path))
+        Info(5);
+    strcpy(addr.sun_path, Opt.serve);
+    unlink(Opt.serve);
+    if ((Listener = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+        bind(Listener, (struct sockaddr *) &addr, sizeof(addr)) || listen(Listener, 64))
     {
-        if (!strcmp(line, "\n"))    /* skip the empty lines*/
+        printf("Error: Can not listen on %s.\n", Opt.serve);
+        exit(1);
+    }
+    signal(SIGPIPE, SIG_IGN);     /* a client hanging up must not stop the server */
+    threads = Opt.lib.threads > 1 ? Opt.lib.threads : 4;
+    Opt.lib.threads = 0;          /* a request runs on its own thread */
+    printf("Serving %d references on %s with %d threads\n", References_n, Opt.serve, threads);
+    fflush(stdout);
+    thread = (pthread_t *) malloc(sizeof(pthread_t) * threads);
+    for (i = 0; i < threads; i++)
+        pthread_create(&thread[i], NULL, Serve_worker, NULL);
+    for (i = 0; i < threads; i++)
+        pthread_join(thread[i], NULL);
+    exit(0);
+}
+
+/******************************************************************************/
+/* Serve_worker: a thread of the server, answering one connection at a time */
+void *Serve_worker(void *arg)
+{
+    struct timeval timeout = {SERVE_TIMEOUT, 0};
+    int client;
+    for (;;)
+        if ((client = accept(Listener, NULL, NULL)) >= 0)
         {
-            --l;
-            continue;
+            /* an idle client must not hold the thread */
+            setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            Serve_request(client);
         }
-        Get_col(line, col, SEPARATORS, column);  /* get a specific column */
-        columns[l] = (char*)malloc(sizeof(char) * (strlen(col)+1)); /* allocal space for column */
-        for(int i = 0; i <= strlen(col); i++)
-            columns[l][i] = col[i];
-    }
-    fclose(file);
-    return columns;
+    return NULL;
 }
 
 /******************************************************************************/
-/* cmp_A & cmp_B : the comparison function for qsort. */
-/* first according to left end point then right end point */
-char ***Columns_A; /* define globle variables for cmp_A & cmp_B */
-char ***Columns_B;
-int cmp_A(const void *a, const void *b)
-{
-    if (strcmp(Columns_A[1][*(int*)a], Columns_A[1][*(int*)b]) < 0)
-        return -1;
-    else if (strcmp(Columns_A[1][*(int*)a], Columns_A[1][*(int*)b]) > 0)
-        return 1;
-    else if (strcmp(Columns_A[2][*(int*)a], Columns_A[2][*(int*)b]) < 0)
-        return -1;
-    else if (strcmp(Columns_A[2][*(int*)a], Columns_A[2][*(int*)b]) > 0)
-        return 1;
+/* Serve_request: read a request from a connection and send the answer.
+   Every request has its own context, so its stats are its own. */
+void Serve_request(int client)
+{
+    FILE *in = fdopen(dup(client), "r"), *out = fdopen(client, "w");
+    char request[REQUEST_SIZE], mode[8], name[REQUEST_SIZE], cols[64], query[REQUEST_SIZE], size[64] = "0";
+    char *data = NULL, *rest, error[2 * REQUEST_SIZE] = "";
+    struct Answer answer[4];
+    struct Reference *ref = NULL;
+    struct timespec start, end;
+    Biodiff_result result = {{NULL, NULL}, {0, 0}, Gather, answer};
+    Biodiff_table *table = NULL;
+    Biodiff *bd = NULL;
+    const Biodiff_stats *stat;
+    unsigned long long bytes = 0;
+    double ms;
+    int col[BIODIFF_MAX_KEY + 1], m = -1, i;
+    memset(answer, 0, sizeof(answer));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!fgets(request, REQUEST_SIZE, in) || sscanf(request, "%7s %1023s %63s %1023s %63s", mode, name, cols, query, size) < 4)
+        strcpy(error, "Usage: mode reference col_b query, the query a file or - and its number of bytes");
+    else if (*size == '-' || (bytes = strtoull(size, &rest, 10)) > MAX_QUERY || *rest)
+        snprintf(error, sizeof(error), "The query size %s is not a number of bytes up to %llu.", size, MAX_QUERY);
+    else if ((m = Get_mode(mode)) < 0)
+        sprintf(error, "Unknown mode %s.", mode);
     else
-        return 0;
+    {
+        for (i = 0; i < References_n; i++)
+            if (!strcmp(References[i].name, name))
+                ref = References + i;
+        if (!ref || !ref -> table[m])
+            snprintf(error, sizeof(error), "The reference %s is not loaded for %s.", name, mode);
+    }
+    if (!*error)
+    {
+        bd = Biodiff_create(&Opt.lib);
+        if (Get_cols(cols, col))
+            snprintf(error, sizeof(error), "Unknown key columns %s.", cols);
+        else if (strcmp(query, "-"))
+            table = Biodiff_table_file(bd, query, col);
+        else if (!(data = (char *) malloc(bytes + 1)))
+            sprintf(error, "No memory for a query of %llu bytes.", bytes);
+        else if (fread(data, 1, bytes, in) == bytes)
+            table = Biodiff_table_buffer(bd, data, bytes, col);
+        else
+            sprintf(error, "The query ended before its %llu bytes.", bytes);
+        if (!*error && (!table || Biodiff_compare(bd, Compare[m], ref -> table[m], table, &result)))
+            snprintf(error, sizeof(error), "%s", Biodiff_error(bd));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    if (*error)
+        fprintf(out, "error %s\n", error);
+    else
+    {
+        for (i = 0; i < 4; i++)
+        {
+            fprintf(out, "%s %ld %lu\n", Targets[i], answer[i].rows, (unsigned long) answer[i].len);
+            fwrite(answer[i].buf, 1, answer[i].len, out);
+        }
+        stat = Biodiff_get_stats(bd);
+        fprintf(out, "stats rows_A=%ld rows_B=%ld matched_A=%ld matched_B=%ld bloom_probes=%ld bloom_rejects=%ld time_ms=%.3f\n",
+                result.rows[0], result.rows[1], answer[0].rows, answer[2].rows, stat -> bloom_probes, stat -> bloom_rejects, ms);
+        printf("%s %s %s: %ld and %ld rows matched in %.3f ms\n", mode, name, query, answer[0].rows, answer[2].rows, ms);
+    }
+    fclose(out);
+    fclose(in);
+    Biodiff_result_free(&result);
+    if (table)
+        Biodiff_table_free(table);
+    if (bd)
+        Biodiff_free(bd);
+    free(data);
+    for (i = 0; i < 4; i++)
+        free(answer[i].buf);
 }
 
-int cmp_B(const void *a, const void *b)
+/******************************************************************************/
+/* Gather: add a row to the result set of its side and its mark */
+void Gather(void *arg, int side, long row, int matched, const char *record)
 {
-    if (strcmp(Columns_B[1][*(int*)a], Columns_B[1][*(int*)b]) < 0)
-        return -1;
-    else if (strcmp(Columns_B[1][*(int*)a], Columns_B[1][*(int*)b]) > 0)
-        return 1;
-    else if (strcmp(Columns_B[2][*(int*)a], Columns_B[2][*(int*)b]) < 0)
-        return -1;
-    else if (strcmp(Columns_B[2][*(int*)a], Columns_B[2][*(int*)b]) > 0)
-        return 1;
-    else
-        return 0;
+    struct Answer *answer = (struct Answer *) arg + side * 2 + !matched;
+    size_t n = strlen(record);
+    if (answer -> len + n > answer -> size)
+    {
+        while (answer -> len + n > answer -> size)
+            answer -> size = answer -> size ? answer -> size * 2 : 4096;
+        answer -> buf = (char *) realloc(answer -> buf, answer -> size);
+    }
+    memcpy(answer -> buf + answer -> len, record, n);
+    answer -> len += n;
+    answer -> rows++;
 }
 /******************************************************************************/
-
-
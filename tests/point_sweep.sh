@@ -0,0 +1,36 @@
+#!/bin/sh
+# point_sweep.sh: [-co] of single positions against intervals, searched unsorted by c_point,
+# must write the same bytes as the sorted sweep, which --cover always takes.
+# usage: sh tests/point_sweep.sh ./Biodiff
+bin=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+dir=$(mktemp -d "${TMPDIR:-/tmp}/point_sweep-XXXXXX")
+fail=0
+cd "$dir" || exit 1
+
+# positions and intervals of 6 digits, some on the bounds of the intervals, some twice
+awk 'BEGIN { srand(45); for (i = 0; i < 20000; i++) { x = 100000 + int(rand() * 50000); if (i % 7 == 0) x = 100000 + 20 * int(rand() * 2500); print "chr1\tp" i "\t" x "\t" x; if (i % 11 == 0) print "chr1\td" i "\t" x "\t" x } }' > P6
+awk 'BEGIN { srand(46); for (i = 0; i < 500; i++) { x = 100000 + 20 * int(rand() * 2500); l = int(rand() * 60) - 2; print "chr1\tr" i "\t" x "\t" x + l } }' > R6
+# positions of 1 to 9 digits: "10" sorts before "9", c_point must leave them to the sweep
+awk 'BEGIN { srand(47); for (i = 0; i < 20000; i++) { x = int(10 ^ (1 + rand() * 8)); print "chr1\tp" i "\t" x "\t" x } }' > P9
+awk 'BEGIN { srand(48); for (i = 0; i < 500; i++) { x = int(10 ^ (1 + rand() * 8)); print "chr1\tr" i "\t" x "\t" x + int(rand() * 1000) } }' > R9
+
+check() {   # files, whether c_point is expected to take them
+    rm -rf point sweep && mkdir point sweep
+    (cd point && "$bin" -co -a 3,4 -b 3,4 "../$1" "../$2" > log) || { echo "FAIL $1 $2: c_point run"; fail=1; }
+    (cd sweep && "$bin" --cover -co -a 3,4 -b 3,4 "../$1" "../$2" > log) || { echo "FAIL $1 $2: sweep run"; fail=1; }
+    for f in 'A&B_A' 'A-B' 'A&B_B' 'B-A'; do
+        cmp -s "point/$f" "sweep/$f" || { echo "FAIL $1 $2: $f differs"; fail=1; }
+    done
+    if grep -q '^Points:' point/log; then taken=1; else taken=0; fi
+    [ "$taken" = "$3" ] || { echo "FAIL $1 $2: c_point taken $taken, expected $3"; fail=1; }
+    echo "$1 $2: $(wc -l < 'point/A&B_A') $(wc -l < 'point/A&B_B') matched, c_point $taken"
+}
+check P6 R6 1
+check R6 P6 1
+check P6 P6 1
+check P9 R9 0
+check R9 P9 0
+
+cd / && rm -rf "$dir"
+[ $fail = 0 ] && echo "point_sweep: ok"
+exit $fail